@@ -0,0 +1,364 @@
+// Batch driver: simulate many programs in forward, noforward and/or exbypass mode on a
+// work-stealing thread pool, writing every diagram plus a summary CSV.
+//
+// Usage: ./batch [options] <program.txt | directory | @list.txt>...
+//   A directory contributes every *.txt file in it. A list file holds one
+//   "<program.txt> [num_cycles]" per line and overrides the cycle budget.
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <thread>
+#include "Pipeline.hpp"
+#include "CpiStack.hpp"
+#include "Superscalar.hpp"
+#include "OutOfOrder.hpp"
+#include "Simulation.hpp"
+#include "ParallelFor.hpp"
+
+using namespace std;
+
+struct BatchJob
+{
+    string inputFile;
+    long numCycles;
+    string mode; // forward, noforward or exbypass
+};
+
+struct BatchResult
+{
+    bool ok;
+    string output;
+    RunStats stats;
+    long branches;      // Conditional branches resolved under a predictor
+    long mispredictions;
+    long btbLookups;
+    long btbHits;
+    long rasReturns;    // Returns predicted by the RAS
+    long rasCorrect;
+    long l1iMisses;
+    long l1dMisses;
+    long l2Misses;
+    long prefetches;    // Issued by the L1D prefetcher
+    long prefetchUseful;
+    bool hasStack;      // stallCycles is filled (5-stage pipeline runs)
+    long stallCycles[NUM_STALL_REASONS];
+};
+
+static void printUsage(const char *prog)
+{
+    cerr << "Usage: " << prog << " [options] <program.txt | directory | @list.txt>..." << endl;
+    cerr << "  --cycles N      cycle budget for programs without one in a list file (default 1000)" << endl;
+    cerr << "  --mode M        forward, noforward, exbypass, both (forward and noforward) or all (default both)" << endl;
+    cerr << "  -j N            worker threads (default: number of cores)" << endl;
+    cerr << "  --outdir DIR    directory for the *_out.txt diagrams (default ../outputfiles)" << endl;
+    cerr << "  --csv FILE      summary file (default <outdir>/summary.csv)" << endl;
+    cerr << "  --bp KIND       branch predictor: none (default), static, bimodal or gshare" << endl;
+    cerr << "  --bp-entries N  predictor table entries, a power of two (default 1024)" << endl;
+    cerr << "  --bp-history H  gshare global history bits (default 10)" << endl;
+    cerr << "  --btb N         N-entry branch target buffer for JAL/JALR (default none)" << endl;
+    cerr << "  --ras N         N-entry return address stack (default none)" << endl;
+    cerr << "  --l1i SPEC      L1 instruction cache, e.g. size=4k,assoc=2,line=32,repl=lru,lat=1 (default none)" << endl;
+    cerr << "  --l1d SPEC      L1 data cache; also wb=0 (write-through) and wa=0 (no write-allocate)" << endl;
+    cerr << "  --l2 SPEC       unified L2 behind both L1s (default none)" << endl;
+    cerr << "  --mem-latency N cycles for an access that misses every cache (default 20)" << endl;
+    cerr << "  --prefetch KIND L1D prefetcher: none (default), nextline, stride or stream" << endl;
+    cerr << "  --prefetch-degree N lines (or strides) fetched ahead (default 2)" << endl;
+    cerr << "  --prefetch-entries N stride table entries, a power of two, or stream buffers (default 16)" << endl;
+    cerr << "  --mul-latency N cycles per multiply, pipelined (default 3)" << endl;
+    cerr << "  --div-latency N cycles per divide/remainder, not pipelined (default 16)" << endl;
+    cerr << "  --width N       superscalar width, 1..8 (default 1: the 5-stage pipeline)" << endl;
+    cerr << "  --ooo           out-of-order core, --width wide" << endl;
+    cerr << "  --rob N         reorder buffer entries (default 32)" << endl;
+    cerr << "  --rs N          reservation station entries per unit class (default 8)" << endl;
+    cerr << "  --lsq N         load/store queue entries (default 16)" << endl;
+    cerr << "  --depth SPEC    split IF, EX and MEM into 1..4 stages each, e.g. if=2,ex=2,mem=2" << endl;
+}
+
+// Expand one command-line operand into (program, cycle budget) pairs
+static bool collectInputs(const string &arg, long numCycles, vector<pair<string, long>> &inputs)
+{
+    namespace fs = std::filesystem;
+    if (!arg.empty() && arg[0] == '@')
+    {
+        ifstream list(arg.substr(1));
+        if (!list)
+        {
+            cerr << "Error: Unable to open list file " << arg.substr(1) << endl;
+            return false;
+        }
+        string line;
+        while (getline(list, line))
+        {
+            stringstream ss(line);
+            string path;
+            long cycles = numCycles;
+            if (!(ss >> path) || path[0] == '#')
+                continue;
+            ss >> cycles;
+            inputs.push_back({path, cycles});
+        }
+        return true;
+    }
+    error_code ec;
+    if (fs::is_directory(arg, ec))
+    {
+        vector<string> files;
+        for (const fs::directory_entry &entry : fs::directory_iterator(arg, ec))
+            if (entry.is_regular_file() && entry.path().extension() == ".txt")
+                files.push_back(entry.path().string());
+        sort(files.begin(), files.end());
+        for (const string &file : files)
+            inputs.push_back({file, numCycles});
+        return true;
+    }
+    inputs.push_back({arg, numCycles});
+    return true;
+}
+
+template <typename Cpu>
+static void simulateJob(Cpu &cpu, const Program &program, const BatchJob &job, const PredictorConfig &bp, const MemoryConfig &caches,
+                        const MulDivConfig &muldiv, bool showSlots, CpiStack *stack, const string &outdir, BatchResult &result)
+{
+    cpu.ConfigurePredictors(bp);
+    cpu.ConfigureCaches(caches);
+    cpu.muldiv = muldiv;
+    PipelineDiagram diagram(program.code.size(), job.numCycles, showSlots);
+    CycleHook afterCycle;
+    if (stack)
+        afterCycle = [&](long) { stack->Count(cpu); };
+    result.stats = RunPipeline(cpu, diagram, job.numCycles, afterCycle);
+    if (stack)
+    {
+        result.hasStack = true;
+        for (int r = 0; r < NUM_STALL_REASONS; r++)
+            result.stallCycles[r] = stack->Cycles((StallReason)r);
+    }
+    if (cpu.predictor)
+    {
+        result.branches = cpu.predictor->Lookups();
+        result.mispredictions = cpu.predictor->Mispredictions();
+    }
+    if (cpu.btb)
+    {
+        result.btbLookups = cpu.btb->Lookups();
+        result.btbHits = cpu.btb->Hits();
+    }
+    if (cpu.ras)
+    {
+        result.rasReturns = cpu.ras->Returns();
+        result.rasCorrect = cpu.ras->Correct();
+    }
+    if (cpu.icache)
+        result.l1iMisses = cpu.icache->Misses();
+    if (cpu.dcache)
+    {
+        result.l1dMisses = cpu.dcache->Misses();
+        result.prefetches = cpu.dcache->PrefetchesIssued();
+        result.prefetchUseful = cpu.dcache->PrefetchesUseful();
+    }
+    if (cpu.l2)
+        result.l2Misses = cpu.l2->Misses();
+    result.output = OutputFileName(job.inputFile, job.mode, outdir);
+    result.ok = WriteDiagramFile(result.output, diagram, program.text);
+}
+
+// Core supplies the bypass policy; ooo runs it on the out-of-order core and
+// width > 1 or a non-default depth on the superscalar core
+template <typename Core>
+static void runJob(const BatchJob &job, const PredictorConfig &bp, const MemoryConfig &caches, const MulDivConfig &muldiv, int width,
+                   const OutOfOrderConfig *ooo, const PipelineDepth &depth, const string &outdir, BatchResult &result)
+{
+    Program program;
+    if (!LoadProgram(job.inputFile, program))
+    {
+        cerr << "Error: Unable to open input file " << job.inputFile << endl;
+        return;
+    }
+    if (ooo)
+    {
+        OutOfOrderCore cpu(program.code, width, *ooo, Core::BYPASS_EX);
+        simulateJob(cpu, program, job, bp, caches, muldiv, false, nullptr, outdir, result);
+        return;
+    }
+    if (width > 1 || !depth.IsDefault())
+    {
+        SuperscalarCore cpu(program.code, width, Core::BYPASS_EX, Core::BYPASS_ID, depth);
+        simulateJob(cpu, program, job, bp, caches, muldiv, width > 1, nullptr, outdir, result);
+        return;
+    }
+    // The 5-stage pipeline also attributes every cycle (the cpi_* columns)
+    Core cpu(program.code);
+    CpiStack stack(program.code.size());
+    simulateJob(cpu, program, job, bp, caches, muldiv, false, &stack, outdir, result);
+}
+
+int main(int argc, char **argv)
+{
+    long numCycles = 1000;
+    string mode = "both";
+    unsigned threads = thread::hardware_concurrency();
+    string outdir = "../outputfiles";
+    string csvFile;
+    PredictorConfig bp;
+    MemoryConfig caches;
+    MulDivConfig muldiv;
+    int width = 1;
+    bool outOfOrder = false;
+    OutOfOrderConfig ooo;
+    PipelineDepth depth;
+    vector<string> operands;
+
+    for (int i = 1; i < argc; i++)
+    {
+        string arg = argv[i];
+        if (arg == "--cycles" && i + 1 < argc)
+            numCycles = atol(argv[++i]);
+        else if (arg == "--mode" && i + 1 < argc)
+            mode = argv[++i];
+        else if (arg == "-j" && i + 1 < argc)
+            threads = atoi(argv[++i]);
+        else if (arg == "--outdir" && i + 1 < argc)
+            outdir = argv[++i];
+        else if (arg == "--csv" && i + 1 < argc)
+            csvFile = argv[++i];
+        else if (arg == "--bp" && i + 1 < argc)
+            bp.kind = argv[++i];
+        else if (arg == "--bp-entries" && i + 1 < argc)
+            bp.entries = atoi(argv[++i]);
+        else if (arg == "--bp-history" && i + 1 < argc)
+            bp.historyBits = atoi(argv[++i]);
+        else if (arg == "--btb" && i + 1 < argc)
+            bp.btbEntries = atoi(argv[++i]);
+        else if (arg == "--ras" && i + 1 < argc)
+            bp.rasDepth = atoi(argv[++i]);
+        else if ((arg == "--l1i" || arg == "--l1d" || arg == "--l2") && i + 1 < argc)
+        {
+            CacheConfig &level = (arg == "--l1i") ? caches.l1i : (arg == "--l1d") ? caches.l1d : caches.l2;
+            if (!ParseCacheSpec(argv[++i], level))
+            {
+                cerr << "Error: invalid cache configuration " << argv[i] << endl;
+                return 1;
+            }
+        }
+        else if (arg == "--mem-latency" && i + 1 < argc)
+            caches.memLatency = atoi(argv[++i]);
+        else if (arg == "--prefetch" && i + 1 < argc)
+            caches.prefetch.kind = argv[++i];
+        else if (arg == "--prefetch-degree" && i + 1 < argc)
+            caches.prefetch.degree = atoi(argv[++i]);
+        else if (arg == "--prefetch-entries" && i + 1 < argc)
+            caches.prefetch.entries = atoi(argv[++i]);
+        else if (arg == "--mul-latency" && i + 1 < argc)
+            muldiv.mulLatency = atoi(argv[++i]);
+        else if (arg == "--div-latency" && i + 1 < argc)
+            muldiv.divLatency = atoi(argv[++i]);
+        else if (arg == "--width" && i + 1 < argc)
+            width = atoi(argv[++i]);
+        else if (arg == "--ooo")
+            outOfOrder = true;
+        else if (arg == "--rob" && i + 1 < argc)
+            ooo.robEntries = atoi(argv[++i]);
+        else if (arg == "--rs" && i + 1 < argc)
+            ooo.rsEntries = atoi(argv[++i]);
+        else if (arg == "--lsq" && i + 1 < argc)
+            ooo.lsqEntries = atoi(argv[++i]);
+        else if (arg == "--depth" && i + 1 < argc)
+        {
+            if (!ParsePipelineDepth(argv[++i], depth))
+            {
+                cerr << "Error: invalid pipeline depth " << argv[i] << endl;
+                return 1;
+            }
+        }
+        else if (arg.size() > 1 && arg[0] == '-')
+        {
+            cerr << "Error: unknown option " << arg << endl;
+            printUsage(argv[0]);
+            return 1;
+        }
+        else
+            operands.push_back(arg);
+    }
+    vector<string> modes;
+    if (mode == "both")
+        modes = {"forward", "noforward"};
+    else if (mode == "all")
+        modes = {"forward", "noforward", "exbypass"};
+    else if (mode == "forward" || mode == "noforward" || mode == "exbypass")
+        modes = {mode};
+    if (operands.empty() || modes.empty() || !ValidPredictorConfig(bp) || !ValidPrefetchConfig(caches.prefetch) ||
+        (caches.prefetch.kind != "none" && caches.l1d.size == 0) || muldiv.mulLatency < 1 || muldiv.divLatency < 1 ||
+        width < 1 || width > 8 || !ValidOutOfOrderConfig(ooo) || (outOfOrder && !depth.IsDefault()))
+    {
+        printUsage(argv[0]);
+        return 1;
+    }
+    if (csvFile.empty())
+        csvFile = outdir + "/summary.csv";
+
+    vector<pair<string, long>> inputs;
+    for (const string &operand : operands)
+        if (!collectInputs(operand, numCycles, inputs))
+            return 1;
+
+    vector<BatchJob> jobs;
+    for (const pair<string, long> &input : inputs)
+    {
+        for (const string &m : modes)
+            jobs.push_back({input.first, input.second, m});
+    }
+
+    // Every job owns its Processor, so jobs share nothing but the results array
+    vector<BatchResult> results(jobs.size(), BatchResult{false, "", {0, 0, 0}, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, false, {}});
+    ParallelFor(jobs.size(), threads, [&](size_t i) {
+        if (jobs[i].mode == "forward")
+            runJob<Processor_F>(jobs[i], bp, caches, muldiv, width, outOfOrder ? &ooo : nullptr, depth, outdir, results[i]);
+        else if (jobs[i].mode == "noforward")
+            runJob<Processor_NF>(jobs[i], bp, caches, muldiv, width, outOfOrder ? &ooo : nullptr, depth, outdir, results[i]);
+        else
+            runJob<Processor_EXB>(jobs[i], bp, caches, muldiv, width, outOfOrder ? &ooo : nullptr, depth, outdir, results[i]);
+    });
+
+    ofstream csv(csvFile);
+    if (!csv)
+    {
+        cerr << "Error: Unable to open output file " << csvFile << endl;
+        return 1;
+    }
+    csv << "program,mode,budget,cycles,instructions,cpi,stalls,branches,mispredictions,btb_lookups,btb_hits,ras_returns,ras_correct,l1i_misses,l1d_misses,l2_misses,prefetches,prefetch_useful,";
+    for (int r = 0; r < NUM_STALL_REASONS; r++)
+        csv << "cpi_" << StallReasonName((StallReason)r) << ",";
+    csv << "output\n";
+    int failures = 0;
+    for (size_t i = 0; i < jobs.size(); i++)
+    {
+        const BatchResult &r = results[i];
+        csv << CsvField(jobs[i].inputFile) << "," << jobs[i].mode << "," << jobs[i].numCycles << ",";
+        if (r.ok)
+        {
+            csv << r.stats.cycles << "," << r.stats.retired << "," << r.stats.CPI() << "," << r.stats.stalls << "," << r.branches << "," << r.mispredictions << ","
+                << r.btbLookups << "," << r.btbHits << "," << r.rasReturns << "," << r.rasCorrect << ","
+                << r.l1iMisses << "," << r.l1dMisses << "," << r.l2Misses << "," << r.prefetches << "," << r.prefetchUseful << ",";
+            // CPI stack: each reason's cycles per retired instruction; the columns add up to cpi
+            for (int s = 0; s < NUM_STALL_REASONS; s++)
+            {
+                if (r.hasStack && r.stats.retired)
+                    csv << (double)r.stallCycles[s] / r.stats.retired;
+                csv << ",";
+            }
+            csv << CsvField(r.output) << "\n";
+        }
+        else
+        {
+            csv << ",,,,,,,,,,,,,,," << string(NUM_STALL_REASONS, ',') << "error\n";
+            failures++;
+        }
+    }
+    cout << jobs.size() - failures << "/" << jobs.size() << " runs written; summary in " << csvFile << endl;
+    return failures ? 1 : 0;
+}
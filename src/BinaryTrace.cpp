@@ -0,0 +1,185 @@
+#include "BinaryTrace.hpp"
+#include <cstdint>
+using namespace std;
+
+static const char MAGIC[4] = {'R', 'V', 'P', 'T'};
+static const int VERSION = 1;
+static const int CODEC_RAW = 0;
+static const size_t CHUNK_BYTES = 64 * 1024;
+
+static void putVarint(string &buf, uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        buf += (char)(value | 0x80);
+        value >>= 7;
+    }
+    buf += (char)value;
+}
+
+static bool getVarint(istream &in, uint64_t &value)
+{
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7)
+    {
+        int byte = in.get();
+        if (byte == EOF)
+            return false;
+        value |= (uint64_t)(byte & 0x7f) << shift;
+        if (!(byte & 0x80))
+            return true;
+    }
+    return false;
+}
+
+static bool getVarint(const char *&p, const char *end, uint64_t &value)
+{
+    value = 0;
+    for (int shift = 0; shift < 64 && p < end; shift += 7)
+    {
+        unsigned char byte = *p++;
+        value |= (uint64_t)(byte & 0x7f) << shift;
+        if (!(byte & 0x80))
+            return true;
+    }
+    return false;
+}
+
+// Row deltas are small and of either sign
+static uint64_t zigzag(int64_t value)
+{
+    return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+}
+
+static int64_t unzigzag(uint64_t value)
+{
+    return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
+
+BinaryTraceWriter::BinaryTraceWriter(ostream &out, const BinaryTraceHeader &header)
+    : out(out), first(0), last(0), row(0)
+{
+    string buf(MAGIC, sizeof(MAGIC));
+    putVarint(buf, VERSION);
+    putVarint(buf, (header.showSlots ? 1 : 0) | (header.oneInSlot ? 2 : 0));
+    putVarint(buf, header.numCycles);
+    putVarint(buf, header.title.size());
+    buf += header.title;
+    putVarint(buf, header.labels.size());
+    for (const string &label : header.labels)
+    {
+        putVarint(buf, label.size());
+        buf += label;
+    }
+    out.write(buf.data(), buf.size());
+}
+
+void BinaryTraceWriter::Cycle(int cycle, const vector<Cell> &cells)
+{
+    if (chunk.empty())
+    {
+        first = last = cycle;
+        row = 0;
+    }
+    putVarint(chunk, cycle - last);
+    putVarint(chunk, cells.size());
+    for (const Cell &cell : cells)
+    {
+        putVarint(chunk, zigzag(cell.row - row));
+        putVarint(chunk, cell.stage | cell.part << 3 | cell.slot << 6);
+        row = cell.row;
+    }
+    last = cycle;
+    if (chunk.size() >= CHUNK_BYTES)
+        flush();
+}
+
+void BinaryTraceWriter::flush()
+{
+    string head(1, (char)CODEC_RAW);
+    putVarint(head, first);
+    putVarint(head, last);
+    putVarint(head, chunk.size());
+    out.write(head.data(), head.size());
+    out.write(chunk.data(), chunk.size());
+    chunk.clear();
+}
+
+void BinaryTraceWriter::Close()
+{
+    if (!chunk.empty())
+        flush();
+}
+
+bool BinaryTraceReader::ReadHeader(BinaryTraceHeader &header)
+{
+    char magic[sizeof(MAGIC)];
+    uint64_t version, flags, numCycles, size, count;
+    if (!in.read(magic, sizeof(magic)) || string(magic, sizeof(magic)) != string(MAGIC, sizeof(MAGIC)) ||
+        !getVarint(in, version) || version != VERSION || !getVarint(in, flags) || !getVarint(in, numCycles) ||
+        !getVarint(in, size))
+        return false;
+    header.title.resize(size);
+    if (!in.read(&header.title[0], size) || !getVarint(in, count))
+        return false;
+    header.labels.assign(count, "");
+    for (string &label : header.labels)
+    {
+        if (!getVarint(in, size))
+            return false;
+        label.resize(size);
+        if (!in.read(&label[0], size))
+            return false;
+    }
+    header.numCycles = numCycles;
+    header.showSlots = flags & 1;
+    header.oneInSlot = flags & 2;
+    rows = count;
+    return true;
+}
+
+bool BinaryTraceReader::Replay(int from, int to, const TraceRecord &record)
+{
+    string chunk;
+    while (true)
+    {
+        int codec = in.get();
+        if (codec == EOF)
+            return true;
+        uint64_t first, last, size;
+        if (codec != CODEC_RAW || !getVarint(in, first) || !getVarint(in, last) || !getVarint(in, size))
+            return false;
+        if ((int64_t)first >= to)
+            return true;
+        if ((int64_t)last < from)
+        {
+            if (!in.seekg(size, ios::cur))
+                return false;
+            continue;
+        }
+
+        chunk.resize(size);
+        if (!in.read(&chunk[0], size))
+            return false;
+        const char *p = chunk.data(), *end = p + size;
+        int64_t cycle = first, row = 0;
+        while (p < end)
+        {
+            uint64_t delta, count;
+            if (!getVarint(p, end, delta) || !getVarint(p, end, count))
+                return false;
+            cycle += delta;
+            for (uint64_t i = 0; i < count; i++)
+            {
+                uint64_t rowDelta, code;
+                if (!getVarint(p, end, rowDelta) || !getVarint(p, end, code))
+                    return false;
+                row += unzigzag(rowDelta);
+                if (row < 0 || row >= rows || (code & 7) < 1 || (code & 7) > 5)
+                    return false;
+                if (cycle >= from && cycle < to)
+                    record((int)cycle, (int)row, code & 7, code >> 6, (code >> 3) & 7);
+            }
+        }
+    }
+}
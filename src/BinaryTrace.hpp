@@ -0,0 +1,70 @@
+#ifndef BINARY_TRACE_HPP
+#define BINARY_TRACE_HPP
+
+#include <functional>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "PipelineTrace.hpp"
+
+// Compact binary form of the diagram records (--trace-bin), rendered
+// offline by ./render. After a header with the row labels, the records
+// follow in chunks of about 64 KiB:
+//
+//   chunk:  codec (1 byte, 0 = raw), first cycle, last cycle, payload bytes, payload
+//   cycle:  cycles since the previous one in the chunk, record count, records
+//   record: row minus the previous row in the chunk (zigzag), stage | part << 3 | slot << 6
+//
+// with every number an unsigned LEB128 varint. A chunk can be skipped
+// without decoding it, which is how a window of cycles is extracted.
+struct BinaryTraceHeader
+{
+    std::string title;               // "<input> (<mode>)"
+    std::vector<std::string> labels; // Assembly text of every row
+    int numCycles;                   // Cycles recorded by the run
+    bool showSlots;                  // Cells name their issue slot ("EX/1")
+    bool oneInSlot;                  // At most one instruction per stage and slot (not the out-of-order core)
+};
+
+class BinaryTraceWriter : public PipelineTrace
+{
+public:
+    // Writes the header right away
+    BinaryTraceWriter(std::ostream &out, const BinaryTraceHeader &header);
+
+protected:
+    void Cycle(int cycle, const std::vector<Cell> &cells) override;
+    void Close() override;
+
+private:
+    std::ostream &out;
+    std::string chunk; // Encoded cycles not written yet
+    int first, last;   // First and last cycle in chunk
+    int row;           // Last row encoded in chunk
+
+    void flush();
+};
+
+// Called for every record replayed from a trace, with the arguments of
+// PipelineDiagram::Record
+typedef std::function<void(int cycle, int row, int stage, int slot, int part)> TraceRecord;
+
+class BinaryTraceReader
+{
+public:
+    explicit BinaryTraceReader(std::istream &in) : in(in) {}
+
+    // false if the stream does not start with a binary trace header
+    bool ReadHeader(BinaryTraceHeader &header);
+    // Pass the records of cycles [from, to) on in the order they were
+    // recorded; chunks outside the window are skipped. Call once, after
+    // ReadHeader. false if the trace is truncated or corrupt.
+    bool Replay(int from, int to, const TraceRecord &record);
+
+private:
+    std::istream &in;
+    int rows = 0;
+};
+
+#endif
@@ -0,0 +1,63 @@
+#include "BranchPredictor.hpp"
+#include <ostream>
+using namespace std;
+
+void BranchPredictor::Report(ostream &out) const
+{
+    out << "Branch predictor " << Name() << ": " << lookups << " branches, "
+        << mispredictions << " mispredicted, accuracy " << Accuracy() * 100 << "%" << endl;
+}
+
+// Counters start weakly not taken
+BimodalPredictor::BimodalPredictor(int entries)
+    : counters(entries, 1), mask(entries - 1)
+{
+}
+
+void BimodalPredictor::Train(int pc, bool taken, uint32_t history)
+{
+    uint8_t &counter = counters[pc & mask];
+    if (taken && counter < 3)
+        counter++;
+    else if (!taken && counter > 0)
+        counter--;
+}
+
+GsharePredictor::GsharePredictor(int entries, int historyBits)
+    : counters(entries, 1), mask(entries - 1), history(0),
+      historyMask(historyBits >= 32 ? ~0u : (1u << historyBits) - 1)
+{
+}
+
+// history is the one Predict used, so the counter it read is trained even
+// if other branches resolved in between (the superscalar and out-of-order
+// cores keep several in flight). The global history itself is updated at
+// resolve.
+void GsharePredictor::Train(int pc, bool taken, uint32_t history)
+{
+    uint8_t &counter = counters[index(pc, history)];
+    if (taken && counter < 3)
+        counter++;
+    else if (!taken && counter > 0)
+        counter--;
+    this->history = ((this->history << 1) | taken) & historyMask;
+}
+
+bool ValidPredictorConfig(const PredictorConfig &config)
+{
+    if (config.kind != "none" && config.kind != "static" && config.kind != "bimodal" && config.kind != "gshare")
+        return false;
+    return config.entries > 0 && (config.entries & (config.entries - 1)) == 0 && config.historyBits >= 0 &&
+           config.btbEntries >= 0 && (config.btbEntries & (config.btbEntries - 1)) == 0 && config.rasDepth >= 0;
+}
+
+unique_ptr<BranchPredictor> MakePredictor(const PredictorConfig &config)
+{
+    if (config.kind == "static")
+        return unique_ptr<BranchPredictor>(new StaticBTFN());
+    if (config.kind == "bimodal")
+        return unique_ptr<BranchPredictor>(new BimodalPredictor(config.entries));
+    if (config.kind == "gshare")
+        return unique_ptr<BranchPredictor>(new GsharePredictor(config.entries, config.historyBits));
+    return nullptr;
+}
@@ -0,0 +1,118 @@
+#ifndef BRANCH_PREDICTOR_HPP
+#define BRANCH_PREDICTOR_HPP
+
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Direction predictor for conditional branches, queried by process_IF when
+// it fetches a B-type instruction and trained when ID resolves it.
+// PCs are instruction indices, as in IF.PC.
+class BranchPredictor
+{
+public:
+    virtual ~BranchPredictor() {}
+
+    // Predicted direction of the branch at pc whose taken target is `target`
+    virtual bool Predict(int pc, int target) = 0;
+
+    virtual const char *Name() const = 0;
+
+    // Global history Predict uses right now. A core that resolves other
+    // branches between Predict and Resolve keeps it and passes it back.
+    virtual uint32_t History() const { return 0; }
+
+    // Resolve the branch at pc, predicted with the current history
+    void Resolve(int pc, bool taken, bool predicted) { Resolve(pc, taken, predicted, History()); }
+    // Resolve the branch at pc, predicted with history; counts the
+    // prediction and trains the entry Predict read
+    void Resolve(int pc, bool taken, bool predicted, uint32_t history)
+    {
+        lookups++;
+        if (taken != predicted)
+            mispredictions++;
+        Train(pc, taken, history);
+    }
+
+    long Lookups() const { return lookups; }
+    long Mispredictions() const { return mispredictions; }
+    double Accuracy() const { return lookups ? 1.0 - (double)mispredictions / lookups : 0.0; }
+
+    // One line: name, branches resolved, mispredictions and accuracy
+    void Report(std::ostream &out) const;
+
+protected:
+    virtual void Train(int pc, bool taken, uint32_t history) = 0;
+
+private:
+    long lookups = 0;
+    long mispredictions = 0;
+};
+
+// Backward taken, forward not taken
+class StaticBTFN : public BranchPredictor
+{
+public:
+    bool Predict(int pc, int target) override { return target <= pc; }
+    const char *Name() const override { return "static"; }
+
+protected:
+    void Train(int pc, bool taken, uint32_t history) override {}
+};
+
+// Table of 2-bit saturating counters indexed by the low PC bits
+class BimodalPredictor : public BranchPredictor
+{
+public:
+    explicit BimodalPredictor(int entries);
+    bool Predict(int pc, int target) override { return counters[pc & mask] >= 2; }
+    const char *Name() const override { return "bimodal"; }
+
+protected:
+    void Train(int pc, bool taken, uint32_t history) override;
+
+private:
+    std::vector<uint8_t> counters;
+    int mask;
+};
+
+// 2-bit counters indexed by PC xor global branch history
+class GsharePredictor : public BranchPredictor
+{
+public:
+    GsharePredictor(int entries, int historyBits);
+    bool Predict(int pc, int target) override { return counters[index(pc, history)] >= 2; }
+    const char *Name() const override { return "gshare"; }
+    uint32_t History() const override { return history; }
+
+protected:
+    void Train(int pc, bool taken, uint32_t history) override;
+
+private:
+    std::vector<uint8_t> counters;
+    int mask;
+    uint32_t history;
+    uint32_t historyMask;
+
+    int index(int pc, uint32_t history) const { return (pc ^ history) & mask; }
+};
+
+// Predictor selection from the command line
+struct PredictorConfig
+{
+    std::string kind = "none"; // none, static, bimodal or gshare
+    int entries = 1024;        // Counter table size (power of two)
+    int historyBits = 10;      // Global history length for gshare
+    int btbEntries = 0;        // JAL/JALR branch target buffer size (power of two, 0 = none)
+    int rasDepth = 0;          // Return address stack depth (0 = none)
+};
+
+// nullptr for "none" (every branch stalls fetch for one cycle, as before)
+std::unique_ptr<BranchPredictor> MakePredictor(const PredictorConfig &config);
+
+// True if config names a known predictor with valid table sizes
+bool ValidPredictorConfig(const PredictorConfig &config);
+
+#endif
@@ -0,0 +1,296 @@
+#include "Cache.hpp"
+#include <climits>
+#include <cstdlib>
+#include <memory>
+#include <ostream>
+#include <sstream>
+#include <string>
+using namespace std;
+
+static bool powerOfTwo(int x)
+{
+    return x > 0 && (x & (x - 1)) == 0;
+}
+
+static int log2i(int x)
+{
+    int bits = 0;
+    while ((1 << bits) < x)
+        bits++;
+    return bits;
+}
+
+bool ParseCacheSpec(const string &spec, CacheConfig &config)
+{
+    stringstream ss(spec);
+    string item;
+    while (getline(ss, item, ','))
+    {
+        size_t eq = item.find('=');
+        if (eq == string::npos)
+            return false;
+        string key = item.substr(0, eq), value = item.substr(eq + 1);
+        if (value.empty())
+            return false;
+        if (key == "repl")
+        {
+            if (value == "lru")
+                config.replacement = REPL_LRU;
+            else if (value == "plru")
+                config.replacement = REPL_PLRU;
+            else if (value == "random")
+                config.replacement = REPL_RANDOM;
+            else
+                return false;
+            continue;
+        }
+
+        // Every other value is a decimal number, "size" and "line" maybe
+        // with a k suffix; "abc" must not read as 0
+        char *end;
+        long number = strtol(value.c_str(), &end, 10);
+        if ((*end == 'k' || *end == 'K') && (key == "size" || key == "line"))
+        {
+            number *= 1024;
+            end++;
+        }
+        if (end == value.c_str() || *end != '\0' || number < INT_MIN || number > INT_MAX)
+            return false;
+
+        if (key == "size")
+            config.size = number;
+        else if (key == "assoc")
+            config.assoc = number;
+        else if (key == "line")
+            config.lineSize = number;
+        else if (key == "lat")
+            config.latency = number;
+        else if (key == "wb")
+            config.writeBack = number != 0;
+        else if (key == "wa")
+            config.writeAllocate = number != 0;
+        else
+            return false;
+    }
+    // A level that is asked for must exist: no size (or size=0) is an error,
+    // not a silently absent cache
+    if (!powerOfTwo(config.size) || !powerOfTwo(config.lineSize) || config.assoc <= 0 || config.latency < 1)
+        return false;
+    if (config.size % (config.assoc * config.lineSize) != 0 || !powerOfTwo(config.size / (config.assoc * config.lineSize)))
+        return false;
+    if (config.replacement == REPL_PLRU && (!powerOfTwo(config.assoc) || config.assoc > 64))
+        return false;
+    return true;
+}
+
+Cache::Cache(const string &name, const CacheConfig &config, Cache *next, int memLatency)
+    : name(name), config(config), next(next), memLatency(memLatency),
+      sets(config.size / (config.assoc * config.lineSize)), ways(config.assoc),
+      lineBits(log2i(config.lineSize)), setBits(log2i(sets)),
+      tags(sets * ways, 0), valid(sets * ways, 0), dirty(sets * ways, 0),
+      lastUse(config.replacement == REPL_LRU ? sets * ways : 0, 0),
+      plruBits(config.replacement == REPL_PLRU ? sets : 0, 0),
+      prefetched(sets * ways, 0), readyAt(sets * ways, 0),
+      clock(0), randomState(0x9E3779B9u)
+{
+}
+
+void Cache::AttachPrefetcher(unique_ptr<Prefetcher> p)
+{
+    prefetcher = move(p);
+}
+
+// Latency of the level behind this one (write-backs and write-through
+// stores drain through a write buffer, so their latency is not charged)
+int Cache::nextLevel(uint32_t addr, bool write)
+{
+    if (next)
+        return next->Access(addr, write);
+    return memLatency;
+}
+
+void Cache::touch(int set, int way)
+{
+    if (config.replacement == REPL_LRU)
+        lastUse[set * ways + way] = ++clock;
+    else if (config.replacement == REPL_PLRU && ways > 1)
+    {
+        // Walk from the root, pointing every node on the path away from way
+        uint64_t &bits = plruBits[set];
+        int node = 0;
+        for (int half = ways / 2; half >= 1; half /= 2)
+        {
+            bool right = (way & half) != 0;
+            if (right)
+                bits &= ~(1ull << node);
+            else
+                bits |= 1ull << node;
+            node = 2 * node + (right ? 2 : 1);
+        }
+    }
+}
+
+int Cache::victim(int set)
+{
+    int base = set * ways;
+    for (int way = 0; way < ways; way++)
+        if (!valid[base + way])
+            return way;
+
+    switch (config.replacement)
+    {
+    case REPL_PLRU:
+    {
+        uint64_t bits = plruBits[set];
+        int node = 0, way = 0;
+        for (int half = ways / 2; half >= 1; half /= 2)
+        {
+            bool right = (bits >> node) & 1;
+            if (right)
+                way |= half;
+            node = 2 * node + (right ? 2 : 1);
+        }
+        return way;
+    }
+    case REPL_RANDOM:
+        // xorshift32: deterministic, so runs are reproducible
+        randomState ^= randomState << 13;
+        randomState ^= randomState >> 17;
+        randomState ^= randomState << 5;
+        return randomState % ways;
+    default:
+    {
+        int oldest = 0;
+        for (int way = 1; way < ways; way++)
+            if (lastUse[base + way] < lastUse[base + oldest])
+                oldest = way;
+        return oldest;
+    }
+    }
+}
+
+int Cache::lookup(int set, uint32_t tag) const
+{
+    int base = set * ways;
+    for (int way = 0; way < ways; way++)
+        if (valid[base + way] && tags[base + way] == tag)
+            return way;
+    return -1;
+}
+
+// Replace a line of set with tag, writing back a dirty victim
+int Cache::fill(int set, uint32_t tag)
+{
+    int base = set * ways;
+    int way = victim(set);
+    if (valid[base + way])
+    {
+        evictions++;
+        if (prefetched[base + way])
+            prefetchUnused++;
+        if (dirty[base + way])
+        {
+            writebacks++;
+            uint32_t victimLine = (tags[base + way] << setBits) | set;
+            nextLevel(victimLine << lineBits, true);
+        }
+    }
+    tags[base + way] = tag;
+    valid[base + way] = 1;
+    dirty[base + way] = 0;
+    prefetched[base + way] = 0;
+    touch(set, way);
+    return way;
+}
+
+// Fill the line holding addr unless it is already present; it arrives once
+// the next level has delivered it
+void Cache::prefetch(uint32_t addr, long now)
+{
+    uint32_t line = addr >> lineBits;
+    int set = line & (sets - 1);
+    uint32_t tag = line >> setBits;
+    if (lookup(set, tag) != -1)
+        return;
+    prefetchIssued++;
+    int latency = nextLevel(addr, false);
+    int way = fill(set, tag);
+    prefetched[set * ways + way] = 1;
+    readyAt[set * ways + way] = now + latency;
+}
+
+int Cache::Access(uint32_t addr, bool write, long now, int pc)
+{
+    uint32_t line = addr >> lineBits;
+    int set = line & (sets - 1);
+    uint32_t tag = line >> setBits;
+    int base = set * ways;
+
+    int latency = config.latency;
+    bool trigger = false;
+    int way = lookup(set, tag);
+    if (way != -1)
+    {
+        hits++;
+        touch(set, way);
+        if (prefetched[base + way])
+        {
+            prefetched[base + way] = 0;
+            prefetchUseful++;
+            trigger = true;
+            if (readyAt[base + way] > now)
+            {
+                prefetchLate++;
+                latency += readyAt[base + way] - now;
+            }
+        }
+    }
+    else
+    {
+        misses++;
+        trigger = true;
+        if (write && !config.writeAllocate)
+        {
+            nextLevel(addr, true);
+            write = false; // Nothing left to do here
+        }
+        else
+        {
+            latency += nextLevel(addr, false);
+            way = fill(set, tag);
+        }
+    }
+    if (write)
+    {
+        if (config.writeBack)
+            dirty[base + way] = 1;
+        else
+            nextLevel(addr, true);
+    }
+
+    if (prefetcher)
+    {
+        candidates.clear();
+        prefetcher->Observe(pc, addr, trigger, candidates);
+        for (uint32_t candidate : candidates)
+            prefetch(candidate, now);
+    }
+    return latency;
+}
+
+void Cache::Report(ostream &out) const
+{
+    out << name << ": " << Accesses() << " accesses, " << hits << " hits ("
+        << (Accesses() ? 100.0 * hits / Accesses() : 0.0) << "%), " << misses << " misses, "
+        << evictions << " evictions, " << writebacks << " writebacks" << endl;
+    if (prefetcher)
+    {
+        // Coverage: share of would-be misses that a prefetch turned into hits
+        long useful = prefetchUseful;
+        out << name << " prefetcher " << prefetcher->Name() << ": " << prefetchIssued << " issued, "
+            << useful << " useful (" << prefetchLate << " late), " << prefetchUnused << " evicted unused; accuracy "
+            << (prefetchIssued ? 100.0 * useful / prefetchIssued : 0.0) << "%, coverage "
+            << (useful + misses ? 100.0 * useful / (useful + misses) : 0.0) << "%, timeliness "
+            << (useful ? 100.0 * (useful - prefetchLate) / useful : 0.0) << "%" << endl;
+    }
+}
@@ -0,0 +1,114 @@
+#ifndef CACHE_HPP
+#define CACHE_HPP
+
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "Prefetcher.hpp"
+
+// Timing-only cache model: it tracks tags and returns access latencies,
+// while the data itself stays in PagedMemory.
+
+enum Replacement
+{
+    REPL_LRU,
+    REPL_PLRU, // Tree pseudo-LRU (associativity must be a power of two)
+    REPL_RANDOM
+};
+
+struct CacheConfig
+{
+    int size = 0;     // Bytes; 0 = no cache at this level
+    int assoc = 1;    // Ways per set
+    int lineSize = 64;
+    Replacement replacement = REPL_LRU;
+    int latency = 1;  // Hit latency in cycles
+    bool writeBack = true;     // Otherwise write-through (through a write buffer, no stall)
+    bool writeAllocate = true; // Otherwise write misses go to the next level without a fill
+};
+
+// Caches of one core; a level with size 0 is absent
+struct MemoryConfig
+{
+    CacheConfig l1i;
+    CacheConfig l1d;
+    CacheConfig l2;       // Unified, behind both L1s
+    int memLatency = 20;  // Cycles for an access that misses every level
+    PrefetchConfig prefetch; // Attached to the L1D
+};
+
+// Parse "size=4096,assoc=2,line=32,repl=lru|plru|random,lat=1,wb=0|1,wa=0|1"
+// (size and line may end in k); false if a key is unknown, a value is not
+// a number, or the size is missing, zero or not a power of two
+bool ParseCacheSpec(const std::string &spec, CacheConfig &config);
+
+class Cache
+{
+public:
+    // next is the level behind this one (nullptr: main memory)
+    Cache(const std::string &name, const CacheConfig &config, Cache *next, int memLatency);
+
+    // Access the line holding addr at cycle now on behalf of the instruction
+    // at pc; returns the latency in cycles including any lower levels. A
+    // 1-cycle result is the pipeline's usual MEM/IF cycle.
+    int Access(uint32_t addr, bool write, long now = 0, int pc = -1);
+
+    // Let prefetcher fill lines after every demand access
+    void AttachPrefetcher(std::unique_ptr<Prefetcher> prefetcher);
+
+    long Accesses() const { return hits + misses; }
+    long Hits() const { return hits; }
+    long Misses() const { return misses; }
+    long Evictions() const { return evictions; }
+    long Writebacks() const { return writebacks; }
+    long PrefetchesIssued() const { return prefetchIssued; }
+    long PrefetchesUseful() const { return prefetchUseful; }
+    long PrefetchesLate() const { return prefetchLate; }
+    void Report(std::ostream &out) const;
+
+private:
+    std::string name;
+    CacheConfig config;
+    Cache *next;
+    int memLatency;
+
+    int sets;
+    int ways;
+    int lineBits;
+    int setBits;
+
+    // Structure of arrays, indexed by set * ways + way, so a lookup scans
+    // one contiguous run of tags
+    std::vector<uint32_t> tags;
+    std::vector<uint8_t> valid;
+    std::vector<uint8_t> dirty;
+    std::vector<uint32_t> lastUse; // LRU: access stamp
+    std::vector<uint64_t> plruBits; // PLRU: one tree per set
+    std::vector<uint8_t> prefetched; // Filled by the prefetcher, not used yet
+    std::vector<long> readyAt;       // Cycle a prefetched line arrives
+    uint32_t clock;
+    uint32_t randomState;
+
+    long hits = 0;
+    long misses = 0;
+    long evictions = 0;
+    long writebacks = 0;
+
+    std::unique_ptr<Prefetcher> prefetcher;
+    std::vector<uint32_t> candidates;
+    long prefetchIssued = 0;
+    long prefetchUseful = 0; // Demand hits on prefetched lines
+    long prefetchLate = 0;   // ... that had not arrived yet
+    long prefetchUnused = 0; // Prefetched lines evicted before any use
+
+    int nextLevel(uint32_t addr, bool write);
+    int lookup(int set, uint32_t tag) const;
+    int fill(int set, uint32_t tag);
+    void prefetch(uint32_t addr, long now);
+    void touch(int set, int way);
+    int victim(int set);
+};
+
+#endif
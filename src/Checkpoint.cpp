@@ -0,0 +1,229 @@
+#include "Checkpoint.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+using namespace std;
+
+static const char MAGIC[8] = {'R', 'V', 'C', 'K', 'P', 'T', '0', '2'};
+
+template <typename T>
+static void put(ostream &out, const T &value)
+{
+    static_assert(is_trivially_copyable<T>::value, "only plain data is written raw");
+    out.write((const char *)&value, sizeof(T));
+}
+
+template <typename T>
+static bool get(istream &in, T &value)
+{
+    static_assert(is_trivially_copyable<T>::value, "only plain data is read raw");
+    return (bool)in.read((char *)&value, sizeof(T));
+}
+
+void Processor::SaveState(ostream &out) const
+{
+    // The latches are written as they are laid out in memory; the header
+    // records their sizes so another build's files are refused
+    put(out, IF);
+    put(out, ID);
+    put(out, EX);
+    put(out, DM);
+    put(out, WB);
+    put(out, RegFile);
+    put(out, now);
+    put(out, regReady);
+    put(out, divFreeAt);
+    put(out, memStall);
+    put(out, fetchWait);
+    put(out, fetchFilled);
+    put(out, slotReason);
+    put(out, slotInstr);
+    put(out, fetchBubble);
+    put(out, fetchBubbleInstr);
+
+    // Pages that were allocated but hold only zeros read back the same
+    // without being stored
+    vector<pair<uint32_t, const uint8_t *>> pages;
+    MEM.ForEachPage([&](uint32_t base, const uint8_t *bytes) {
+        if (any_of(bytes, bytes + PagedMemory::PAGE_SIZE, [](uint8_t b) { return b != 0; }))
+            pages.push_back({base, bytes});
+    });
+    put(out, (uint32_t)pages.size());
+    for (const pair<uint32_t, const uint8_t *> &page : pages)
+    {
+        put(out, page.first);
+        out.write((const char *)page.second, PagedMemory::PAGE_SIZE);
+    }
+}
+
+bool Processor::RestoreState(istream &in)
+{
+    IFStage ifStage;
+    IDStage idStage;
+    EXStage exStage;
+    MEMStage memStage;
+    WBStage wbStage;
+    Register regs[32];
+    long cycles, ready[32], divFree;
+    int stallLeft, fetchLeft;
+    bool filled;
+    StallReason reason, bubble;
+    int reasonInstr, bubbleInstr;
+    uint32_t pageCount;
+    if (!get(in, ifStage) || !get(in, idStage) || !get(in, exStage) || !get(in, memStage) || !get(in, wbStage) ||
+        !get(in, regs) || !get(in, cycles) || !get(in, ready) || !get(in, divFree) || !get(in, stallLeft) ||
+        !get(in, fetchLeft) || !get(in, filled) || !get(in, reason) || !get(in, reasonInstr) || !get(in, bubble) ||
+        !get(in, bubbleInstr) || !get(in, pageCount))
+        return false;
+
+    MEM.Clear();
+    vector<uint8_t> bytes(PagedMemory::PAGE_SIZE);
+    for (uint32_t i = 0; i < pageCount; i++)
+    {
+        uint32_t base;
+        if (!get(in, base) || !in.read((char *)bytes.data(), bytes.size()))
+            return false;
+        for (uint32_t offset = 0; offset < PagedMemory::PAGE_SIZE; offset += 4)
+        {
+            uint32_t word;
+            memcpy(&word, bytes.data() + offset, 4);
+            MEM.Store<4>(base + offset, word);
+        }
+    }
+
+    IF = ifStage;
+    ID = idStage;
+    EX = exStage;
+    DM = memStage;
+    WB = wbStage;
+    copy(regs, regs + 32, RegFile);
+    now = cycles;
+    copy(ready, ready + 32, regReady);
+    divFreeAt = divFree;
+    memStall = stallLeft;
+    fetchWait = fetchLeft;
+    fetchFilled = filled;
+    slotReason = reason;
+    slotInstr = reasonInstr;
+    fetchBubble = bubble;
+    fetchBubbleInstr = bubbleInstr;
+    return true;
+}
+
+// FNV-1a over the decoded fields, so a checkpoint is only restored into the
+// program it was taken from
+static uint64_t programHash(const vector<DecodedInstr> &program)
+{
+    uint64_t hash = 14695981039346656037ull;
+    auto mix = [&](int64_t value) {
+        for (int i = 0; i < 8; i++)
+        {
+            hash ^= (value >> (8 * i)) & 0xFF;
+            hash *= 1099511628211ull;
+        }
+    };
+    for (const DecodedInstr &instr : program)
+    {
+        mix(instr.Class);
+        mix(instr.RR1);
+        mix(instr.RR2);
+        mix(instr.WR);
+        mix(instr.Imm);
+        mix(instr.ALUOp);
+        mix(instr.MemSize);
+        mix(instr.BranchType);
+    }
+    return hash;
+}
+
+// Everything the header checks, in file order
+struct CheckpointHeader
+{
+    uint64_t programHash;
+    uint32_t programSize;
+    uint32_t latchSizes[5];
+    uint32_t modeLength;
+};
+
+static CheckpointHeader makeHeader(const Processor &cpu, const string &mode)
+{
+    CheckpointHeader header;
+    memset(&header, 0, sizeof(header)); // No stray padding bytes in the file
+    header.programHash = programHash(cpu.program);
+    header.programSize = cpu.program.size();
+    uint32_t sizes[5] = {sizeof(IFStage), sizeof(IDStage), sizeof(EXStage), sizeof(MEMStage), sizeof(WBStage)};
+    copy(sizes, sizes + 5, header.latchSizes);
+    header.modeLength = mode.size();
+    return header;
+}
+
+bool WriteCheckpoint(const Processor &cpu, const string &mode, const string &path)
+{
+    // Written next to the target and renamed, so a run that dies while
+    // writing leaves the previous checkpoint intact
+    string temporary = path + ".tmp";
+    {
+        ofstream out(temporary, ios::binary);
+        if (!out)
+        {
+            cerr << "Error: Unable to open output file " << temporary << endl;
+            return false;
+        }
+        out.write(MAGIC, sizeof(MAGIC));
+        put(out, makeHeader(cpu, mode));
+        out.write(mode.data(), mode.size());
+        cpu.SaveState(out);
+        if (!out.flush())
+        {
+            cerr << "Error: Unable to write checkpoint " << temporary << endl;
+            return false;
+        }
+    }
+    if (rename(temporary.c_str(), path.c_str()) != 0)
+    {
+        cerr << "Error: Unable to write checkpoint " << path << endl;
+        return false;
+    }
+    return true;
+}
+
+bool ReadCheckpoint(Processor &cpu, const string &mode, const string &path)
+{
+    ifstream in(path, ios::binary);
+    if (!in)
+    {
+        cerr << "Error: Unable to open checkpoint " << path << endl;
+        return false;
+    }
+    char magic[sizeof(MAGIC)];
+    CheckpointHeader header;
+    if (!in.read(magic, sizeof(magic)) || memcmp(magic, MAGIC, sizeof(MAGIC)) != 0 || !get(in, header))
+    {
+        cerr << "Error: " << path << " is not a checkpoint of this simulator" << endl;
+        return false;
+    }
+    CheckpointHeader expected = makeHeader(cpu, mode);
+    string savedMode(min(header.modeLength, 64u), '\0');
+    if (header.modeLength > 64 || !in.read(&savedMode[0], savedMode.size()) ||
+        memcmp(header.latchSizes, expected.latchSizes, sizeof(expected.latchSizes)) != 0)
+    {
+        cerr << "Error: " << path << " was written by another build of the simulator" << endl;
+        return false;
+    }
+    if (savedMode != mode || header.programSize != expected.programSize || header.programHash != expected.programHash)
+    {
+        cerr << "Error: " << path << " was taken from another program or pipeline mode (" << savedMode << ")" << endl;
+        return false;
+    }
+    if (!cpu.RestoreState(in))
+    {
+        cerr << "Error: checkpoint " << path << " is truncated" << endl;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,22 @@
+#ifndef CHECKPOINT_HPP
+#define CHECKPOINT_HPP
+
+#include <string>
+#include "Processor.hpp"
+
+// Binary snapshots of the 5-stage pipeline (--checkpoint / --restore). A
+// file holds a header naming the pipeline mode and the program it was taken
+// from, followed by Processor::SaveState: the latches, RegFile, the timing
+// state (including why the last cycle's slot and IF were empty, so the CPI
+// stack charges the first restored cycles as the long run would) and every
+// MEM page that is not all zero. The CPI stack and profile counts are not
+// saved; after --restore they cover the cycles from the restore point on.
+
+// false (after printing an error) if path cannot be written
+bool WriteCheckpoint(const Processor &cpu, const std::string &mode, const std::string &path);
+
+// false (after printing an error) if path cannot be read, is damaged, or
+// was written by another mode or for another program
+bool ReadCheckpoint(Processor &cpu, const std::string &mode, const std::string &path);
+
+#endif
@@ -0,0 +1,108 @@
+#include "ChromeTrace.hpp"
+#include "PipelineDiagram.hpp"
+#include "Simulation.hpp"
+using namespace std;
+
+static const int STALL_TRACK = 900;
+
+// Tracks sort in pipeline order: IF, ID, EX1, EX2, ..., slots within each
+static int trackId(int stage, int part, int slot)
+{
+    return stage * 100 + part * 10 + slot;
+}
+
+ChromeTrace::ChromeTrace(ostream &out, const vector<string> &labels, const string &processName, bool showSlots)
+    : out(out), showSlots(showSlots), open(labels.size(), Open{0, 0, 0, 0, 0}), named(1000, false),
+      stall{0, 0, 0, 0, 0}, stallInstr(-1)
+{
+    for (const string &label : labels)
+        names.push_back(JsonQuote(label));
+    out << "{\"traceEvents\":[\n";
+    out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":" << JsonQuote(processName) << "}}";
+}
+
+void ChromeTrace::name(int tid, const string &trackName)
+{
+    named[tid] = true;
+    out << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << tid << ",\"args\":{\"name\":" << JsonQuote(trackName) << "}}";
+    out << ",\n{\"name\":\"thread_sort_index\",\"ph\":\"M\",\"pid\":1,\"tid\":" << tid << ",\"args\":{\"sort_index\":" << tid << "}}";
+}
+
+void ChromeTrace::event(const string &name, int tid, int start, int end, int pc, int stalled)
+{
+    out << ",\n{\"name\":" << name << ",\"ph\":\"X\",\"ts\":" << start << ",\"dur\":" << end - start
+        << ",\"pid\":1,\"tid\":" << tid << ",\"args\":{";
+    if (pc >= 0)
+        out << "\"pc\":" << pc << (stalled > 0 ? "," : "");
+    if (stalled > 0)
+        out << "\"stalled\":" << stalled;
+    out << "}}";
+}
+
+void ChromeTrace::emit(int row, const Open &run)
+{
+    int tid = trackId(run.stage, run.part, run.slot);
+    if (!named[tid])
+    {
+        string trackName = stageName(run.stage);
+        if (run.part)
+            trackName += to_string(run.part);
+        if (showSlots)
+            trackName += "/" + to_string(run.slot);
+        name(tid, trackName);
+    }
+    event(names[row], tid, run.start, run.last + 1, row, run.last - run.start);
+}
+
+void ChromeTrace::Cycle(int cycle, const vector<Cell> &cells)
+{
+    for (size_t i = 0; i < cells.size(); i++)
+    {
+        if (!Shown(cells, i))
+            continue;
+        const Cell &cell = cells[i];
+        Open &o = open[cell.row];
+        if (o.stage == cell.stage && o.slot == cell.slot && o.part == cell.part && o.last == cycle - 1)
+        {
+            o.last = cycle;
+            continue;
+        }
+        if (o.stage)
+            emit(cell.row, o);
+        o = {cell.stage, cell.slot, cell.part, cycle, cycle};
+    }
+}
+
+void ChromeTrace::Stall(int cycle, StallReason reason, int instr)
+{
+    if (reason != STALL_NONE && stall.stage == reason && stallInstr == instr && stall.last == cycle - 1)
+    {
+        stall.last = cycle;
+        return;
+    }
+    endStall();
+    if (reason != STALL_NONE)
+    {
+        stall = {reason, 0, 0, cycle, cycle};
+        stallInstr = instr;
+    }
+}
+
+void ChromeTrace::endStall()
+{
+    if (!stall.stage)
+        return;
+    if (!named[STALL_TRACK])
+        name(STALL_TRACK, "stalls");
+    event(JsonQuote(StallReasonName((StallReason)stall.stage)), STALL_TRACK, stall.start, stall.last + 1, stallInstr, 0);
+    stall.stage = 0;
+}
+
+void ChromeTrace::Close()
+{
+    for (size_t row = 0; row < open.size(); row++)
+        if (open[row].stage)
+            emit(row, open[row]);
+    endStall();
+    out << "\n],\n\"otherData\":{\"time unit\":\"1 us = 1 cycle\"}}\n";
+}
@@ -0,0 +1,55 @@
+#ifndef CHROME_TRACE_HPP
+#define CHROME_TRACE_HPP
+
+#include <ostream>
+#include <string>
+#include <vector>
+#include "PipelineTrace.hpp"
+#include "CpiStack.hpp"
+
+// Chrome trace-event JSON (--trace FILE), for chrome://tracing and
+// Perfetto, showing the cells of the diagram. Every stage (and sub-stage
+// or issue slot) is a track; each
+// stay of an instruction in a stage is one complete event on it, from the
+// cycle it entered to the cycle it left, with the cycles it was held there
+// as "stalled". One cycle is one microsecond on the time axis. Events are
+// written as soon as they end, so memory stays at one open event per
+// instruction of the program.
+class ChromeTrace : public PipelineTrace
+{
+public:
+    // processName titles the trace; with showSlots every issue slot gets
+    // its own track ("EX/1")
+    ChromeTrace(std::ostream &out, const std::vector<std::string> &labels, const std::string &processName, bool showSlots);
+
+    // What kept ID from passing an instruction to EX in cycle (5-stage
+    // pipeline): runs of the same reason become events on a "stalls" track
+    void Stall(int cycle, StallReason reason, int instr);
+
+protected:
+    void Cycle(int cycle, const std::vector<Cell> &cells) override;
+    void Close() override;
+
+private:
+    struct Open
+    {
+        int stage; // 0: none
+        int slot, part;
+        int start, last; // First and last cycle
+    };
+
+    std::ostream &out;
+    std::vector<std::string> names; // Labels as JSON strings
+    bool showSlots;
+    std::vector<Open> open;    // Per row
+    std::vector<bool> named;   // Tracks whose name has been written
+    Open stall;                // Current run of the stalls track (stage = reason)
+    int stallInstr;
+
+    void event(const std::string &name, int tid, int start, int end, int pc, int stalled);
+    void emit(int row, const Open &run);
+    void endStall();
+    void name(int tid, const std::string &trackName);
+};
+
+#endif
@@ -0,0 +1,126 @@
+#include "CpiStack.hpp"
+#include "Processor.hpp"
+#include "Simulation.hpp"
+#include <algorithm>
+#include <numeric>
+using namespace std;
+
+static const char *const NAMES[NUM_STALL_REASONS] = {"base", "load_use", "branch_operand", "jalr_operand", "raw", "muldiv",
+                                                     "structural", "control", "icache", "dcache", "empty"};
+
+const char *StallReasonName(StallReason reason)
+{
+    return NAMES[reason];
+}
+
+CpiStack::CpiStack(int programSize)
+    : perInstr((size_t)programSize * NUM_STALL_REASONS, 0)
+{
+    fill(run, run + NUM_STALL_REASONS, 0);
+}
+
+void CpiStack::Count(const Processor &cpu)
+{
+    // Cycles with nothing in the pipeline (an I-cache miss, or past the end
+    // of the program) only belong to the run if something follows them, as
+    // in RunPipeline's cycle count
+    bool busy = cpu.IF.InStr != -1 || cpu.ID.InStr != -1 || cpu.EX.InStr != -1 || cpu.DM.InStr != -1 || cpu.WB.InStr != -1;
+    if (!busy)
+    {
+        if (!idle.empty() && idle.back().reason == cpu.SlotReason() && idle.back().instr == cpu.SlotInstr())
+            idle.back().cycles++;
+        else
+            idle.push_back({cpu.SlotReason(), cpu.SlotInstr(), 1});
+        return;
+    }
+    for (const Span &span : idle)
+        charge(span.reason, span.instr, span.cycles);
+    idle.clear();
+    charge(cpu.SlotReason(), cpu.SlotInstr(), 1);
+}
+
+void CpiStack::charge(StallReason reason, int instr, long cycles)
+{
+    run[reason] += cycles;
+    if (instr >= 0 && (size_t)instr < perInstr.size() / NUM_STALL_REASONS)
+        perInstr[instr * NUM_STALL_REASONS + reason] += cycles;
+}
+
+long CpiStack::Cycles() const
+{
+    return accumulate(run, run + NUM_STALL_REASONS, 0L);
+}
+
+long CpiStack::Cycles(int instr, StallReason reason) const
+{
+    if (instr < 0 || (size_t)instr >= perInstr.size() / NUM_STALL_REASONS)
+        return 0;
+    return perInstr[instr * NUM_STALL_REASONS + reason];
+}
+
+long CpiStack::Cycles(int instr) const
+{
+    if (instr < 0 || (size_t)instr >= perInstr.size() / NUM_STALL_REASONS)
+        return 0;
+    const long *cycles = &perInstr[instr * NUM_STALL_REASONS];
+    return accumulate(cycles, cycles + NUM_STALL_REASONS, 0L);
+}
+
+void CpiStack::Report(ostream &out) const
+{
+    // Instructions are counted as they enter EX
+    long instrs = max(run[STALL_NONE], 1L);
+    out << "CPI stack: " << (double)Cycles() / instrs << " =";
+    for (int r = 0; r < NUM_STALL_REASONS; r++)
+        if (run[r] > 0 || r == STALL_NONE)
+            out << (r == STALL_NONE ? " " : " + ") << NAMES[r] << " " << (double)run[r] / instrs;
+    out << endl;
+}
+
+void CpiStack::WriteCsv(ostream &out, const vector<string> &labels) const
+{
+    out << "pc,instruction,cycles";
+    for (int r = 0; r < NUM_STALL_REASONS; r++)
+        out << "," << NAMES[r];
+    out << "\nall,," << Cycles();
+    for (int r = 0; r < NUM_STALL_REASONS; r++)
+        out << "," << run[r];
+    out << "\n";
+
+    for (size_t pc = 0; pc < labels.size() && pc < perInstr.size() / NUM_STALL_REASONS; pc++)
+    {
+        const long *cycles = &perInstr[pc * NUM_STALL_REASONS];
+        long total = Cycles((int)pc);
+        if (total == 0)
+            continue;
+        out << pc << "," << CsvField(labels[pc]) << "," << total;
+        for (int r = 0; r < NUM_STALL_REASONS; r++)
+            out << "," << cycles[r];
+        out << "\n";
+    }
+}
+
+void CpiStack::WriteJson(ostream &out, const vector<string> &labels) const
+{
+    long instrs = max(run[STALL_NONE], 1L);
+    out << "{\n  \"cycles\": " << Cycles() << ",\n  \"instructions\": " << run[STALL_NONE] << ",\n  \"cpi\": " << (double)Cycles() / instrs
+        << ",\n  \"stack\": {";
+    for (int r = 0; r < NUM_STALL_REASONS; r++)
+        out << (r ? ", " : "") << "\"" << NAMES[r] << "\": {\"cycles\": " << run[r] << ", \"cpi\": " << (double)run[r] / instrs << "}";
+    out << "},\n  \"per_instruction\": [";
+
+    bool first = true;
+    for (size_t pc = 0; pc < labels.size() && pc < perInstr.size() / NUM_STALL_REASONS; pc++)
+    {
+        const long *cycles = &perInstr[pc * NUM_STALL_REASONS];
+        long total = Cycles((int)pc);
+        if (total == 0)
+            continue;
+        out << (first ? "\n" : ",\n") << "    {\"pc\": " << pc << ", \"instruction\": " << JsonQuote(labels[pc]) << ", \"cycles\": " << total;
+        for (int r = 0; r < NUM_STALL_REASONS; r++)
+            out << ", \"" << NAMES[r] << "\": " << cycles[r];
+        out << "}";
+        first = false;
+    }
+    out << "\n  ]\n}\n";
+}
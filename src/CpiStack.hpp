@@ -0,0 +1,76 @@
+#ifndef CPI_STACK_HPP
+#define CPI_STACK_HPP
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+class Processor;
+
+// Why ID passed no instruction to EX in a cycle. A cycle in which it did
+// counts as STALL_NONE (the base component of the CPI stack).
+enum StallReason
+{
+    STALL_NONE,           // An instruction entered EX
+    STALL_LOAD_USE,       // Operand of an ALU/memory instruction is loaded by the instruction ahead
+    STALL_BRANCH_OPERAND, // Branch waits in ID for an operand
+    STALL_JALR_OPERAND,   // JALR waits in ID for its base register
+    STALL_RAW,            // Operand not yet back in RegFile (no bypass into EX)
+    STALL_MULDIV,         // Operand still in the multiplier or divider
+    STALL_STRUCTURAL,     // Division waits for the divider
+    STALL_CONTROL,        // Fetch squashed behind a branch or jump
+    STALL_ICACHE,         // Fetch waits for an I-cache miss
+    STALL_DCACHE,         // Pipeline held by a D-cache miss in MEM
+    STALL_EMPTY,          // Nothing fetched: pipeline fill, or past the end of the program
+    NUM_STALL_REASONS
+};
+
+// Column name of a reason in the reports (e.g. "load_use")
+const char *StallReasonName(StallReason reason);
+
+// Per-cycle attribution of a 5-stage pipeline run. Every cycle is charged
+// to one reason and, where there is one, to the static instruction it
+// concerns: the instruction that entered EX, the one held in ID, the
+// branch or jump behind a squashed fetch, the fetch that missed in the
+// I-cache or the load/store that missed in the D-cache. Summed over the
+// run the reasons give the cycles RunPipeline reports; divided by the
+// instructions retired they give the CPI stack.
+class CpiStack
+{
+public:
+    explicit CpiStack(int programSize);
+
+    // Charge the cycle cpu has just clocked
+    void Count(const Processor &cpu);
+
+    long Cycles() const;
+    long Cycles(StallReason reason) const { return run[reason]; }
+    // Cycles charged to static instruction instr, for one reason or all
+    long Cycles(int instr, StallReason reason) const;
+    long Cycles(int instr) const;
+
+    // One line: CPI and each reason's share of it
+    void Report(std::ostream &out) const;
+    // A row for the whole run ("all") and one per static instruction that
+    // was charged, with the cycles of every reason
+    void WriteCsv(std::ostream &out, const std::vector<std::string> &labels) const;
+    // The same as a JSON object, with the CPI of every reason for the run
+    void WriteJson(std::ostream &out, const std::vector<std::string> &labels) const;
+
+private:
+    // Consecutive cycles with the same reason and instruction
+    struct Span
+    {
+        StallReason reason;
+        int instr;
+        long cycles;
+    };
+
+    std::vector<long> perInstr; // NUM_STALL_REASONS cycles per static instruction
+    long run[NUM_STALL_REASONS];
+    std::vector<Span> idle; // Cycles with an empty pipeline, not charged yet
+
+    void charge(StallReason reason, int instr, long cycles);
+};
+
+#endif
@@ -1,9 +0,0 @@
-#ifndef DECODER_F_HPP
-#define DECODER_F_HPP
-
-#include <string>
-#include "Processor.hpp" 
-
-void Decoder_F(std::string opcode, std::string instr);
-
-#endif
\ No newline at end of file
@@ -0,0 +1,175 @@
+#ifndef EXECUTE_HPP
+#define EXECUTE_HPP
+
+#include <cstdint>
+#include "Memory.hpp"
+#include "Predecode.hpp"
+
+// Instruction semantics shared by the pipeline stages and the functional model
+
+// ALU operation selected by ID.ALUOp
+inline int ALUCompute(int ALUOp, int arg1, int arg2)
+{
+    switch (ALUOp)
+    {
+    case 2: // ADD (also used for address calculation)
+        return arg1 + arg2;
+    case 3: // SUB
+        return arg1 - arg2;
+    case 4: // AND
+        return arg1 & arg2;
+    case 5: // OR
+        return arg1 | arg2;
+    case 6: // XOR
+        return arg1 ^ arg2;
+    case 7: // SLL (Shift Left Logical)
+        return arg1 << arg2;
+    case 8: // SRL (Shift Right Logical)
+        return (unsigned int)arg1 >> arg2;
+    case 9: // SRA (Shift Right Arithmetic)
+        return arg1 >> arg2;
+    case 10: // SLT (Set Less Than, signed)
+        return (arg1 < arg2) ? 1 : 0;
+    case 11: // SLTU (Set Less Than Unsigned)
+        return ((unsigned int)arg1 < (unsigned int)arg2) ? 1 : 0;
+    case 12: // MUL (Signed multiplication, lower 32 bits)
+        return (int32_t)((uint32_t)arg1 * (uint32_t)arg2);
+    case 13: // MULH (Signed x Signed, upper 32 bits)
+        return (int32_t)((int64_t)arg1 * (int64_t)arg2 >> 32);
+    case 14: // MULHU (Unsigned x Unsigned, upper 32 bits)
+        return (uint32_t)((uint64_t)(uint32_t)arg1 * (uint64_t)(uint32_t)arg2 >> 32);
+    case 15: // MULHSU (Signed x Unsigned, upper 32 bits)
+        return (int32_t)((int64_t)arg1 * (int64_t)(uint32_t)arg2 >> 32);
+    case 16: // DIV (Signed division), -1 on division by zero, INT32_MIN on overflow
+        if (arg2 == 0)
+            return -1;
+        return (arg1 == INT32_MIN && arg2 == -1) ? INT32_MIN : arg1 / arg2;
+    case 17: // DIVU (Unsigned division), all ones on division by zero
+        return (arg2 == 0) ? (unsigned int)-1 : (unsigned int)arg1 / (unsigned int)arg2;
+    case 18: // REM (Signed remainder), dividend on division by zero, 0 on overflow
+        if (arg2 == 0)
+            return arg1;
+        return (arg1 == INT32_MIN && arg2 == -1) ? 0 : arg1 % arg2;
+    case 19: // REMU (Unsigned remainder), dividend on division by zero
+        return (arg2 == 0) ? (unsigned int)arg1 : (unsigned int)arg1 % (unsigned int)arg2;
+    case 20: // LUI (Load Upper Immediate)
+        return arg2; // Pass through immediate value
+    default:
+        return arg1 + arg2;
+    }
+}
+
+// ALU operations executed by the multiplier (MUL, MULH, MULHU, MULHSU)
+inline bool IsMultiply(int ALUOp)
+{
+    return ALUOp >= 12 && ALUOp <= 15;
+}
+
+// ALU operations executed by the divider (DIV, DIVU, REM, REMU)
+inline bool IsDivide(int ALUOp)
+{
+    return ALUOp >= 16 && ALUOp <= 19;
+}
+
+// Branch condition selected by ID.BranchType
+inline bool BranchTaken(int BranchType, int arg1, int arg2)
+{
+    switch (BranchType)
+    {
+    case 0: // BEQ: Branch if Equal
+        return arg1 == arg2;
+    case 1: // BNE: Branch if Not Equal
+        return arg1 != arg2;
+    case 2: // BLT: Branch if Less Than (signed)
+        return arg1 < arg2;
+    case 3: // BGE: Branch if Greater or Equal (signed)
+        return arg1 >= arg2;
+    case 4: // BLTU: Branch if Less Than (unsigned)
+        return (unsigned)arg1 < (unsigned)arg2;
+    case 5: // BGEU: Branch if Greater or Equal (unsigned)
+        return (unsigned)arg1 >= (unsigned)arg2;
+    default:
+        return false;
+    }
+}
+
+// Little-endian load of 1, 2 or 4 bytes with optional sign extension
+inline int LoadMem(const PagedMemory &MEM, int Address, int MemSize, bool MemSignExtend)
+{
+    switch (MemSize)
+    {
+    case 1: // Byte
+        return MemSignExtend ? (int8_t)MEM.Load<1>(Address) : (int)MEM.Load<1>(Address);
+    case 2: // Halfword (16-bit)
+        return MemSignExtend ? (int16_t)MEM.Load<2>(Address) : (int)MEM.Load<2>(Address);
+    case 4: // Word (32-bit)
+        return (int)MEM.Load<4>(Address);
+    default:
+        return 0;
+    }
+}
+
+// Little-endian store of the low 1, 2 or 4 bytes of Data
+inline void StoreMem(PagedMemory &MEM, int Address, int MemSize, int Data)
+{
+    switch (MemSize)
+    {
+    case 1:
+        MEM.Store<1>(Address, Data);
+        break;
+    case 2:
+        MEM.Store<2>(Address, Data);
+        break;
+    case 4:
+        MEM.Store<4>(Address, Data);
+        break;
+    }
+}
+
+// Architectural outcome of one instruction
+struct ExecOutcome
+{
+    int next;    // Index of the next instruction
+    int result;  // Value for rd (when instr.RegWrite)
+    int address; // Effective address of a load or store
+    bool taken;  // Conditional branch taken
+};
+
+// Execute instr, at instruction index pc, with source operands arg1 (rs1)
+// and arg2 (rs2). Loads and stores access MEM; rd is left to the caller.
+inline ExecOutcome ExecuteInstr(const DecodedInstr &instr, int pc, int arg1, int arg2, PagedMemory &MEM)
+{
+    ExecOutcome out = {pc + 1, 0, 0, false};
+    switch (instr.Class)
+    {
+    case CLASS_ALU:
+        out.result = ALUCompute(instr.ALUOp, arg1, instr.ALUSrc ? instr.Imm : arg2);
+        break;
+    case CLASS_LOAD:
+        out.address = arg1 + instr.Imm;
+        out.result = LoadMem(MEM, out.address, instr.MemSize, instr.MemSignExtend);
+        break;
+    case CLASS_STORE:
+        out.address = arg1 + instr.Imm;
+        StoreMem(MEM, out.address, instr.MemSize, arg2);
+        break;
+    case CLASS_BRANCH:
+        out.taken = BranchTaken(instr.BranchType, arg1, arg2);
+        if (out.taken)
+            out.next = pc + instr.Imm / 4;
+        break;
+    case CLASS_JAL: // rd gets the index of the next instruction
+        out.result = pc + 1;
+        out.next = pc + instr.Imm / 4;
+        break;
+    case CLASS_JALR:
+        out.result = pc + 1;
+        out.next = (arg1 + instr.Imm) / 4;
+        break;
+    default: // Unsupported encodings do nothing
+        break;
+    }
+    return out;
+}
+
+#endif
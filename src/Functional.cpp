@@ -0,0 +1,53 @@
+#include "Functional.hpp"
+#include "Execute.hpp"
+#include "Processor.hpp"
+#include <algorithm>
+#include <ostream>
+#include <vector>
+using namespace std;
+
+long RunFunctional(Processor &cpu, int &pc, long maxInstrs, int stopPC)
+{
+    const DecodedInstr *code = cpu.program.data();
+    const int size = cpu.program.size();
+    Register *RegFile = cpu.RegFile;
+    PagedMemory &MEM = cpu.MEM;
+    // Work on a local copy of the register file; stores through MEM would
+    // otherwise force RegFile to be reloaded after every instruction.
+    int regs[32];
+    for (int i = 0; i < 32; i++)
+        regs[i] = RegFile[i].value;
+
+    long count = 0;
+    while (count < maxInstrs && pc >= 0 && pc < size && pc != stopPC)
+    {
+        const DecodedInstr &instr = code[pc];
+        int arg1 = regs[max(0, (int)instr.RR1)];
+        int arg2 = regs[max(0, (int)instr.RR2)];
+        ExecOutcome out = ExecuteInstr(instr, pc, arg1, arg2, MEM);
+        if (instr.RegWrite && instr.WR != 0)
+            regs[instr.WR] = out.result;
+        pc = out.next;
+        count++;
+    }
+
+    for (int i = 0; i < 32; i++)
+        RegFile[i].value = regs[i];
+    return count;
+}
+
+void DumpArchState(const Processor &cpu, ostream &out)
+{
+    const Register *RegFile = cpu.RegFile;
+    const PagedMemory &MEM = cpu.MEM;
+    for (int i = 0; i < 32; i++)
+        out << "x" << i << " = " << RegFile[i].value << "\n";
+    MEM.ForEachPage([&](uint32_t base, const uint8_t *bytes) {
+        for (uint32_t offset = 0; offset < PagedMemory::PAGE_SIZE; offset += 4)
+        {
+            int word = bytes[offset] | (bytes[offset + 1] << 8) | (bytes[offset + 2] << 16) | (bytes[offset + 3] << 24);
+            if (word != 0)
+                out << "MEM[" << base + offset << "] = " << word << "\n";
+        }
+    });
+}
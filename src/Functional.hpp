@@ -0,0 +1,18 @@
+#ifndef FUNCTIONAL_HPP
+#define FUNCTIONAL_HPP
+
+#include <ostream>
+#include <vector>
+#include "Processor.hpp"
+
+// Architectural (ISA-level) execution without pipeline timing.
+// Executes at most maxInstrs instructions of cpu.program starting at
+// instruction index pc, updating cpu.RegFile, cpu.MEM and pc. Stops early
+// when pc leaves the program or reaches stopPC. Returns the number of
+// instructions executed.
+long RunFunctional(Processor &cpu, int &pc, long maxInstrs, int stopPC = -1);
+
+// Print the register file and every non-zero memory word
+void DumpArchState(const Processor &cpu, std::ostream &out);
+
+#endif
@@ -0,0 +1,91 @@
+#include "HotProfile.hpp"
+#include "Processor.hpp"
+#include <algorithm>
+using namespace std;
+
+HotProfile::HotProfile(int programSize)
+    : executions(programSize, 0), resident((size_t)programSize * 5, 0)
+{
+    fill(shown, shown + 5, -1);
+}
+
+void HotProfile::Occupy(const Processor &cpu)
+{
+    // Same stage mapping as RunPipeline's diagram
+    if (!cpu.MemoryStalled())
+    {
+        shown[0] = cpu.IF.PC;
+        shown[1] = cpu.IF.InStr;
+        shown[2] = cpu.ID.InStr;
+        shown[3] = cpu.EX.InStr;
+        shown[4] = cpu.DM.InStr;
+    }
+    else
+        shown[4] = -1;
+    for (int stage = 0; stage < 5; stage++)
+        if (shown[stage] >= 0 && shown[stage] < (int)executions.size())
+            resident[shown[stage] * 5 + stage]++;
+}
+
+void HotProfile::Retire(const Processor &cpu)
+{
+    if (cpu.WB.InStr >= 0 && cpu.WB.InStr < (int)executions.size())
+        executions[cpu.WB.InStr]++;
+}
+
+vector<int> HotProfile::ranked(const CpiStack &stack) const
+{
+    vector<int> order;
+    for (int pc = 0; pc < (int)executions.size(); pc++)
+        if (stack.Cycles(pc) > 0 || any_of(&resident[pc * 5], &resident[pc * 5] + 5, [](long c) { return c > 0; }))
+            order.push_back(pc);
+    stable_sort(order.begin(), order.end(), [&](int a, int b) { return stack.Cycles(a) > stack.Cycles(b); });
+    return order;
+}
+
+// The stall reason most cycles of instr were lost to, "" if none
+static const char *topStall(const CpiStack &stack, int instr)
+{
+    const char *top = "";
+    long most = 0;
+    for (int r = STALL_NONE + 1; r < NUM_STALL_REASONS; r++)
+        if (stack.Cycles(instr, (StallReason)r) > most)
+        {
+            most = stack.Cycles(instr, (StallReason)r);
+            top = StallReasonName((StallReason)r);
+        }
+    return top;
+}
+
+void HotProfile::Write(ostream &out, const vector<string> &labels, const CpiStack &stack) const
+{
+    long total = max(stack.Cycles(), 1L);
+    out << "instruction;pc;cost%;cycles;executions;stalls;top_stall;IF;ID;EX;MEM;WB\n";
+    for (int pc : ranked(stack))
+    {
+        long cycles = stack.Cycles(pc);
+        out << ((pc < (int)labels.size()) ? labels[pc] : "") << ';' << pc << ';' << 100.0 * cycles / total << ';' << cycles << ';'
+            << executions[pc] << ';' << cycles - stack.Cycles(pc, STALL_NONE) << ';' << topStall(stack, pc);
+        for (int stage = 0; stage < 5; stage++)
+            out << ';' << resident[pc * 5 + stage];
+        out << '\n';
+    }
+}
+
+void HotProfile::Report(ostream &out, const vector<string> &labels, const CpiStack &stack, int count) const
+{
+    long total = max(stack.Cycles(), 1L);
+    vector<int> order = ranked(stack);
+    out << "Hottest instructions:" << endl;
+    for (int i = 0; i < count && i < (int)order.size() && stack.Cycles(order[i]) > 0; i++)
+    {
+        int pc = order[i];
+        long cycles = stack.Cycles(pc);
+        long stalls = cycles - stack.Cycles(pc, STALL_NONE);
+        out << "  " << 100.0 * cycles / total << "% " << pc << ": " << ((pc < (int)labels.size()) ? labels[pc] : "") << " ("
+            << executions[pc] << " executions, " << stalls << " stall cycles";
+        if (stalls > 0)
+            out << ", mostly " << topStall(stack, pc);
+        out << ")" << endl;
+    }
+}
@@ -0,0 +1,44 @@
+#ifndef HOT_PROFILE_HPP
+#define HOT_PROFILE_HPP
+
+#include <ostream>
+#include <string>
+#include <vector>
+#include "CpiStack.hpp"
+
+class Processor;
+
+// Per static instruction counters of a 5-stage pipeline run (--profile), in
+// flat arrays indexed by instruction: how often it retired and how many
+// cycles it spent in each stage, counted as the diagram shows it (IF is
+// the PC being fetched, a D-cache miss holds every stage and empties WB).
+// Its cycles and stall cycles come from the run's CpiStack, so the costs
+// of all instructions add up to the run.
+class HotProfile
+{
+public:
+    explicit HotProfile(int programSize);
+
+    // Count the stages of the coming cycle; call before every recorded cycle
+    void Occupy(const Processor &cpu);
+    // Count the instruction that retired in the cycle just clocked
+    void Retire(const Processor &cpu);
+
+    // One ';'-separated line per instruction that was fetched or charged,
+    // most expensive first: label, index, share of the run's cycles,
+    // cycles, executions, stall cycles, the reason behind most of them and
+    // the cycles in IF..WB
+    void Write(std::ostream &out, const std::vector<std::string> &labels, const CpiStack &stack) const;
+    // The `count` most expensive instructions
+    void Report(std::ostream &out, const std::vector<std::string> &labels, const CpiStack &stack, int count = 5) const;
+
+private:
+    std::vector<long> executions;
+    std::vector<long> resident; // 5 stage counters per instruction
+    int shown[5];               // Instruction in IF..WB during the coming cycle
+
+    // Instructions with anything counted, most expensive first
+    std::vector<int> ranked(const CpiStack &stack) const;
+};
+
+#endif
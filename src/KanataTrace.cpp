@@ -0,0 +1,117 @@
+#include "KanataTrace.hpp"
+#include "PipelineDiagram.hpp"
+#include <algorithm>
+using namespace std;
+
+// Pipeline order of a stage or sub-stage
+static int order(int stage, int part)
+{
+    return stage * 16 + part;
+}
+
+KanataTrace::KanataTrace(ostream &out, const vector<string> &labels)
+    : out(out), labels(labels), names(order(6, 0))
+{
+    for (int stage = 1; stage <= 5; stage++)
+        for (int part = 0; part < 16; part++)
+            names[order(stage, part)] = part ? stageName(stage) + to_string(part) : stageName(stage);
+    out << "Kanata\t0004\n";
+}
+
+// Move the log's clock to cycle
+void KanataTrace::advance(int cycle)
+{
+    if (last < 0)
+        out << "C=\t" << cycle << '\n';
+    else if (cycle > last)
+        out << "C\t" << cycle - last << '\n';
+    last = cycle;
+}
+
+void KanataTrace::start(const Live &instr)
+{
+    out << "S\t" << instr.id << "\t0\t" << names[order(instr.stage, instr.part)] << '\n';
+}
+
+// End the current stage of instr and take it out of the pipeline: retired
+// from WB, flushed from anywhere else
+void KanataTrace::end(const Live &instr)
+{
+    out << "E\t" << instr.id << "\t0\t" << names[order(instr.stage, instr.part)] << '\n';
+    if (instr.stage == 5)
+        out << "R\t" << instr.id << '\t' << retired++ << "\t0\n";
+    else
+        out << "R\t" << instr.id << "\t0\t1\n";
+}
+
+void KanataTrace::Cycle(int cycle, const vector<Cell> &cells)
+{
+    // Nothing was recorded in the cycles between: the pipeline emptied
+    if (last >= 0 && cycle > last + 1 && !live.empty())
+    {
+        advance(last + 1);
+        for (const Live &instr : live)
+            end(instr);
+        live.clear();
+    }
+    advance(cycle);
+
+    // Each instruction in flight, furthest along first, moves to the next
+    // stage of its row if that was recorded, else stays if its own stage
+    // was, else has left the pipeline
+    vector<bool> taken(cells.size(), false);
+    vector<Live> next;
+    for (Live instr : live)
+    {
+        int now = order(instr.stage, instr.part);
+        int moved = -1, stayed = -1;
+        for (size_t i = 0; i < cells.size(); i++)
+        {
+            const Cell &cell = cells[i];
+            if (taken[i] || cell.row != instr.row)
+                continue;
+            int to = order(cell.stage, cell.part);
+            if (to == now)
+                stayed = i;
+            else if (to > now && cell.stage <= instr.stage + 1 && (moved < 0 || to < order(cells[moved].stage, cells[moved].part)))
+                moved = i;
+        }
+        if (moved >= 0)
+        {
+            out << "E\t" << instr.id << "\t0\t" << names[order(instr.stage, instr.part)] << '\n';
+            instr.stage = cells[moved].stage;
+            instr.part = cells[moved].part;
+            start(instr);
+            taken[moved] = true;
+            next.push_back(instr);
+        }
+        else if (stayed >= 0)
+        {
+            taken[stayed] = true;
+            next.push_back(instr);
+        }
+        else
+            end(instr);
+    }
+
+    // What is left entered the pipeline this cycle
+    for (size_t i = 0; i < cells.size(); i++)
+    {
+        const Cell &cell = cells[i];
+        if (taken[i])
+            continue;
+        bool repeated = false;
+        for (const Live &instr : next)
+            repeated = repeated || (instr.row == cell.row && instr.stage == cell.stage && instr.part == cell.part);
+        if (repeated)
+            continue;
+        Live instr = {fetched++, cell.row, cell.stage, cell.part};
+        out << "I\t" << instr.id << '\t' << instr.id << "\t0\n";
+        out << "L\t" << instr.id << "\t0\t" << instr.row << ": " << ((instr.row < (int)labels.size()) ? labels[instr.row] : "") << '\n';
+        start(instr);
+        next.push_back(instr);
+    }
+
+    stable_sort(next.begin(), next.end(), [](const Live &a, const Live &b) { return order(a.stage, a.part) > order(b.stage, b.part); });
+    live.swap(next);
+}
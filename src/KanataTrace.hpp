@@ -0,0 +1,46 @@
+#ifndef KANATA_TRACE_HPP
+#define KANATA_TRACE_HPP
+
+#include <ostream>
+#include <string>
+#include <vector>
+#include "PipelineTrace.hpp"
+
+// Kanata log (--kanata FILE) for the Konata pipeline viewer. Every fetch
+// is a dynamic instruction with its own id: "I" and an "L" label with its
+// assembly text when it enters the pipeline, "S"/"E" when it starts and
+// ends a stage (or sub-stage), "R" when it leaves WB (retire) or drops
+// out before it (flush), with "C" lines advancing the cycle. Instructions
+// are followed through all records of a cycle, so a short loop that
+// refetches an instruction still in flight shows both instances. Lines
+// are written cycle by cycle; memory is the instructions in flight.
+class KanataTrace : public PipelineTrace
+{
+public:
+    KanataTrace(std::ostream &out, const std::vector<std::string> &labels);
+
+protected:
+    void Cycle(int cycle, const std::vector<Cell> &cells) override;
+
+private:
+    struct Live
+    {
+        long id;
+        int row;
+        int stage, part;
+    };
+
+    std::ostream &out;
+    std::vector<std::string> labels;
+    std::vector<std::string> names; // Stage names, indexed in pipeline order
+    std::vector<Live> live;         // In flight, furthest along first
+    long fetched = 0;               // Ids given out
+    long retired = 0;               // Retire ids given out
+    int last = -1;                  // Cycle of the last lines written
+
+    void advance(int cycle);
+    void start(const Live &instr);
+    void end(const Live &instr);
+};
+
+#endif
@@ -0,0 +1,7 @@
+#include "Pipeline.hpp"
+#include "SimulatorMain.hpp"
+
+int main(int argc, char **argv)
+{
+    return SimulatorMain<Processor_F>(argc, argv, "forward");
+}
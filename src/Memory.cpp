@@ -0,0 +1,36 @@
+#include "Memory.hpp"
+using namespace std;
+
+PagedMemory::PagedMemory()
+    : pagesTouched(0), lastPageNumber(~0u), lastPage(nullptr)
+{
+}
+
+uint8_t *PagedMemory::touchPage(uint32_t addr)
+{
+    uint32_t number = addr >> PAGE_BITS;
+    if (number == lastPageNumber)
+        return lastPage;
+
+    unique_ptr<Directory> &dir = directory[number >> 10];
+    if (!dir)
+        dir.reset(new Directory());
+    unique_ptr<Page> &page = dir->pages[number & (DIR_ENTRIES - 1)];
+    if (!page)
+    {
+        page.reset(new Page()); // value-initialized, so the page starts zeroed
+        pagesTouched++;
+    }
+    lastPageNumber = number;
+    lastPage = page->bytes;
+    return lastPage;
+}
+
+void PagedMemory::Clear()
+{
+    for (uint32_t hi = 0; hi < DIR_ENTRIES; hi++)
+        directory[hi].reset();
+    pagesTouched = 0;
+    lastPageNumber = ~0u;
+    lastPage = nullptr;
+}
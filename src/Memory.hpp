@@ -0,0 +1,210 @@
+#ifndef MEMORY_HPP
+#define MEMORY_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#ifdef MEM_CHECKS
+#include <iostream>
+#endif
+
+// Sparse guest memory covering the full 32-bit address space.
+// 4 KiB pages are allocated (zero-filled) on the first write; reads of
+// untouched pages return 0 without allocating. A two-level page table
+// (10 + 10 bits) keeps the unused part of the address space free.
+class PagedMemory
+{
+public:
+    static const uint32_t PAGE_BITS = 12;
+    static const uint32_t PAGE_SIZE = 1u << PAGE_BITS;
+
+    PagedMemory();
+
+    // Little-endian access of W = 1, 2 or 4 bytes; the value is zero-extended
+    template <int W>
+    uint32_t Load(uint32_t addr) const;
+    template <int W>
+    void Store(uint32_t addr, uint32_t value);
+
+    // Same, with the width chosen at run time
+    uint32_t Read(uint32_t addr, int size) const;
+    void Write(uint32_t addr, int size, uint32_t value);
+
+    uint8_t ReadByte(uint32_t addr) const;
+    void WriteByte(uint32_t addr, uint8_t value);
+
+    // Number of pages allocated so far
+    size_t PagesTouched() const { return pagesTouched; }
+
+    // Call f(base_address, page_bytes) for every allocated page, in address order
+    template <typename F>
+    void ForEachPage(F f) const
+    {
+        for (uint32_t hi = 0; hi < DIR_ENTRIES; hi++)
+        {
+            if (!directory[hi])
+                continue;
+            for (uint32_t lo = 0; lo < DIR_ENTRIES; lo++)
+                if (directory[hi]->pages[lo])
+                    f(((hi << 10) | lo) << PAGE_BITS, (const uint8_t *)directory[hi]->pages[lo]->bytes);
+        }
+    }
+
+    // Release every page
+    void Clear();
+
+private:
+    static const uint32_t DIR_ENTRIES = 1024;
+
+    struct Page
+    {
+        uint8_t bytes[PAGE_SIZE];
+    };
+    struct Directory
+    {
+        std::unique_ptr<Page> pages[DIR_ENTRIES];
+    };
+
+    std::unique_ptr<Directory> directory[DIR_ENTRIES];
+    size_t pagesTouched;
+
+    // Last page used, so sequential accesses skip the table walk
+    mutable uint32_t lastPageNumber;
+    mutable uint8_t *lastPage;
+
+    template <int W> struct WidthType;
+
+    const uint8_t *findPage(uint32_t addr) const;
+    uint8_t *touchPage(uint32_t addr);
+    template <int W>
+    void checkAccess(uint32_t addr, const char *kind) const;
+};
+
+template <> struct PagedMemory::WidthType<1> { typedef uint8_t type; };
+template <> struct PagedMemory::WidthType<2> { typedef uint16_t type; };
+template <> struct PagedMemory::WidthType<4> { typedef uint32_t type; };
+
+inline const uint8_t *PagedMemory::findPage(uint32_t addr) const
+{
+    uint32_t number = addr >> PAGE_BITS;
+    if (number == lastPageNumber)
+        return lastPage;
+    const Directory *dir = directory[number >> 10].get();
+    if (!dir || !dir->pages[number & (DIR_ENTRIES - 1)])
+        return nullptr;
+    lastPageNumber = number;
+    lastPage = dir->pages[number & (DIR_ENTRIES - 1)]->bytes;
+    return lastPage;
+}
+
+// Checked builds (make CHECKS=1) report misaligned accesses and accesses
+// that run past the top of the address space; otherwise this compiles out.
+template <int W>
+inline void PagedMemory::checkAccess(uint32_t addr, const char *kind) const
+{
+#ifdef MEM_CHECKS
+    if (addr & (W - 1))
+        std::cerr << "Warning: misaligned " << W << "-byte " << kind << " at 0x" << std::hex << addr << std::dec << std::endl;
+    if (addr > 0xFFFFFFFFu - (W - 1))
+        std::cerr << "Warning: " << W << "-byte " << kind << " at 0x" << std::hex << addr << std::dec << " wraps past the end of memory" << std::endl;
+#else
+    (void)addr;
+    (void)kind;
+#endif
+}
+
+template <int W>
+inline uint32_t PagedMemory::Load(uint32_t addr) const
+{
+    static_assert(W == 1 || W == 2 || W == 4, "access width must be 1, 2 or 4 bytes");
+    checkAccess<W>(addr, "load");
+    uint32_t offset = addr & (PAGE_SIZE - 1);
+    if (offset + W <= PAGE_SIZE)
+    {
+        const uint8_t *page = findPage(addr);
+        if (!page)
+            return 0;
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        // Host is little-endian like the guest: one unaligned-safe copy
+        typename WidthType<W>::type value;
+        memcpy(&value, page + offset, W);
+        return value;
+#else
+        uint32_t value = 0;
+        for (int i = 0; i < W; i++)
+            value |= (uint32_t)page[offset + i] << (8 * i);
+        return value;
+#endif
+    }
+    // Access crossing a page boundary
+    uint32_t value = 0;
+    for (int i = 0; i < W; i++)
+        value |= (uint32_t)ReadByte(addr + i) << (8 * i);
+    return value;
+}
+
+template <int W>
+inline void PagedMemory::Store(uint32_t addr, uint32_t value)
+{
+    static_assert(W == 1 || W == 2 || W == 4, "access width must be 1, 2 or 4 bytes");
+    checkAccess<W>(addr, "store");
+    uint32_t offset = addr & (PAGE_SIZE - 1);
+    if (offset + W <= PAGE_SIZE)
+    {
+        uint8_t *page = touchPage(addr);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        typename WidthType<W>::type narrow = value;
+        memcpy(page + offset, &narrow, W);
+#else
+        for (int i = 0; i < W; i++)
+            page[offset + i] = (value >> (8 * i)) & 0xFF;
+#endif
+        return;
+    }
+    for (int i = 0; i < W; i++)
+        WriteByte(addr + i, (value >> (8 * i)) & 0xFF);
+}
+
+inline uint32_t PagedMemory::Read(uint32_t addr, int size) const
+{
+    switch (size)
+    {
+    case 1:
+        return Load<1>(addr);
+    case 2:
+        return Load<2>(addr);
+    case 4:
+        return Load<4>(addr);
+    default:
+        return 0;
+    }
+}
+
+inline void PagedMemory::Write(uint32_t addr, int size, uint32_t value)
+{
+    switch (size)
+    {
+    case 1:
+        Store<1>(addr, value);
+        return;
+    case 2:
+        Store<2>(addr, value);
+        return;
+    case 4:
+        Store<4>(addr, value);
+        return;
+    }
+}
+
+inline uint8_t PagedMemory::ReadByte(uint32_t addr) const
+{
+    const uint8_t *page = findPage(addr);
+    return page ? page[addr & (PAGE_SIZE - 1)] : 0;
+}
+
+inline void PagedMemory::WriteByte(uint32_t addr, uint8_t value)
+{
+    touchPage(addr)[addr & (PAGE_SIZE - 1)] = value;
+}
+
+#endif
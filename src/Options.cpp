@@ -0,0 +1,235 @@
+#include "Options.hpp"
+#include <iostream>
+#include <string>
+#include <cstdlib>
+using namespace std;
+
+static void printUsage(const char *prog)
+{
+    cerr << "Usage: " << prog << " <input.txt> <num_cycles> [options]" << endl;
+    cerr << "  --functional   execute without pipeline timing; num_cycles is the instruction budget" << endl;
+    cerr << "  --ff N         execute the first N instructions functionally, then simulate num_cycles in detail" << endl;
+    cerr << "  --ff-pc P      execute functionally until instruction index P (within --ff N, default 100M instructions), then simulate in detail" << endl;
+    cerr << "  --bp KIND      branch predictor: none (default), static, bimodal or gshare" << endl;
+    cerr << "  --bp-entries N predictor table entries, a power of two (default 1024)" << endl;
+    cerr << "  --bp-history H gshare global history bits (default 10)" << endl;
+    cerr << "  --btb N        N-entry branch target buffer for JAL/JALR, a power of two (default none)" << endl;
+    cerr << "  --ras N        N-entry return address stack (default none)" << endl;
+    cerr << "  --l1i SPEC     L1 instruction cache, e.g. size=4k,assoc=2,line=32,repl=lru,lat=1 (default none)" << endl;
+    cerr << "  --l1d SPEC     L1 data cache; also wb=0 (write-through) and wa=0 (no write-allocate)" << endl;
+    cerr << "  --l2 SPEC      unified L2 behind both L1s (default none)" << endl;
+    cerr << "  --mem-latency N cycles for an access that misses every cache (default 20)" << endl;
+    cerr << "  --prefetch KIND L1D prefetcher: none (default), nextline, stride or stream" << endl;
+    cerr << "  --prefetch-degree N lines (or strides) fetched ahead (default 2)" << endl;
+    cerr << "  --prefetch-entries N stride table entries, a power of two, or stream buffers (default 16)" << endl;
+    cerr << "  --mul-latency N cycles per multiply, pipelined (default 3)" << endl;
+    cerr << "  --div-latency N cycles per divide/remainder, not pipelined (default 16)" << endl;
+    cerr << "  --width N      fetch, issue and retire up to N instructions per cycle, 1..8 (default 1)" << endl;
+    cerr << "  --ooo          out-of-order core; --width is its fetch, dispatch and commit width" << endl;
+    cerr << "  --rob N        out-of-order reorder buffer entries (default 32)" << endl;
+    cerr << "  --rs N         reservation station entries per unit class (default 8)" << endl;
+    cerr << "  --lsq N        load/store queue entries (default 16)" << endl;
+    cerr << "  --depth SPEC   split IF, EX and MEM into 1..4 stages each, e.g. if=2,ex=2,mem=2" << endl;
+    cerr << "  --checkpoint FILE save the pipeline state to FILE after num_cycles cycles" << endl;
+    cerr << "  --checkpoint-every N also save it every N cycles, for resuming a run that dies" << endl;
+    cerr << "  --restore FILE resume from a checkpoint of the same program and mode" << endl;
+    cerr << "  --sample N     sampled simulation with N-instruction intervals; num_cycles is the instruction budget" << endl;
+    cerr << "  --sample-clusters K basic-block vector clusters (default 8)" << endl;
+    cerr << "  --sample-per-cluster N intervals simulated in detail per cluster (default 2)" << endl;
+    cerr << "  --sample-warmup N instructions simulated before each interval to warm the pipeline (default 0)" << endl;
+    cerr << "  --profile      write <input>_<mode>_profile_out.txt: cycles, executions, stalls and stage cycles per instruction, hottest first" << endl;
+    cerr << "  --trace FILE   stream the pipeline timeline to FILE as Chrome trace-event JSON (Perfetto)" << endl;
+    cerr << "  --kanata FILE  stream every instruction's fetch, stages and retire or flush to FILE as a Kanata log (Konata)" << endl;
+    cerr << "  --trace-bin FILE write the diagram as a compact binary trace instead of <input>_<mode>_out.txt; ./render turns it into text, CSV or JSON" << endl;
+    cerr << "  --cpi-stack FILE write the cycles lost per stall reason, for the run and per instruction (CSV, or JSON for *.json)" << endl;
+}
+
+bool ParseOptions(int argc, char **argv, SimOptions &options)
+{
+    if (argc < 3)
+    {
+        printUsage(argv[0]);
+        return false;
+    }
+    options.inputFile = argv[1];
+    options.numCycles = atol(argv[2]);
+    options.functional = false;
+    options.ffInstrs = -1;
+    options.ffPC = -1;
+    options.width = 1;
+    options.outOfOrder = false;
+    options.checkpointEvery = 0;
+    options.profile = false;
+
+    for (int i = 3; i < argc; i++)
+    {
+        string arg = argv[i];
+        if (arg == "--functional")
+            options.functional = true;
+        else if (arg == "--ff" && i + 1 < argc)
+            options.ffInstrs = atol(argv[++i]);
+        else if (arg == "--ff-pc" && i + 1 < argc)
+            options.ffPC = atoi(argv[++i]);
+        else if (arg == "--bp" && i + 1 < argc)
+            options.predictor.kind = argv[++i];
+        else if (arg == "--bp-entries" && i + 1 < argc)
+            options.predictor.entries = atoi(argv[++i]);
+        else if (arg == "--bp-history" && i + 1 < argc)
+            options.predictor.historyBits = atoi(argv[++i]);
+        else if (arg == "--btb" && i + 1 < argc)
+            options.predictor.btbEntries = atoi(argv[++i]);
+        else if (arg == "--ras" && i + 1 < argc)
+            options.predictor.rasDepth = atoi(argv[++i]);
+        else if ((arg == "--l1i" || arg == "--l1d" || arg == "--l2") && i + 1 < argc)
+        {
+            CacheConfig &level = (arg == "--l1i") ? options.caches.l1i : (arg == "--l1d") ? options.caches.l1d : options.caches.l2;
+            if (!ParseCacheSpec(argv[++i], level))
+            {
+                cerr << "Error: invalid cache configuration " << argv[i] << endl;
+                return false;
+            }
+        }
+        else if (arg == "--mem-latency" && i + 1 < argc)
+            options.caches.memLatency = atoi(argv[++i]);
+        else if (arg == "--prefetch" && i + 1 < argc)
+            options.caches.prefetch.kind = argv[++i];
+        else if (arg == "--prefetch-degree" && i + 1 < argc)
+            options.caches.prefetch.degree = atoi(argv[++i]);
+        else if (arg == "--prefetch-entries" && i + 1 < argc)
+            options.caches.prefetch.entries = atoi(argv[++i]);
+        else if (arg == "--mul-latency" && i + 1 < argc)
+            options.muldiv.mulLatency = atoi(argv[++i]);
+        else if (arg == "--div-latency" && i + 1 < argc)
+            options.muldiv.divLatency = atoi(argv[++i]);
+        else if (arg == "--width" && i + 1 < argc)
+            options.width = atoi(argv[++i]);
+        else if (arg == "--ooo")
+            options.outOfOrder = true;
+        else if (arg == "--rob" && i + 1 < argc)
+            options.ooo.robEntries = atoi(argv[++i]);
+        else if (arg == "--rs" && i + 1 < argc)
+            options.ooo.rsEntries = atoi(argv[++i]);
+        else if (arg == "--lsq" && i + 1 < argc)
+            options.ooo.lsqEntries = atoi(argv[++i]);
+        else if (arg == "--checkpoint" && i + 1 < argc)
+            options.checkpointFile = argv[++i];
+        else if (arg == "--checkpoint-every" && i + 1 < argc)
+            options.checkpointEvery = atol(argv[++i]);
+        else if (arg == "--restore" && i + 1 < argc)
+            options.restoreFile = argv[++i];
+        else if (arg == "--sample" && i + 1 < argc)
+            options.sample.interval = atol(argv[++i]);
+        else if (arg == "--sample-clusters" && i + 1 < argc)
+            options.sample.clusters = atoi(argv[++i]);
+        else if (arg == "--sample-per-cluster" && i + 1 < argc)
+            options.sample.perCluster = atoi(argv[++i]);
+        else if (arg == "--sample-warmup" && i + 1 < argc)
+            options.sample.warmup = atol(argv[++i]);
+        else if (arg == "--cpi-stack" && i + 1 < argc)
+            options.cpiStackFile = argv[++i];
+        else if (arg == "--profile")
+            options.profile = true;
+        else if (arg == "--trace" && i + 1 < argc)
+            options.traceFile = argv[++i];
+        else if (arg == "--kanata" && i + 1 < argc)
+            options.kanataFile = argv[++i];
+        else if (arg == "--trace-bin" && i + 1 < argc)
+            options.binTraceFile = argv[++i];
+        else if (arg == "--depth" && i + 1 < argc)
+        {
+            if (!ParsePipelineDepth(argv[++i], options.depth))
+            {
+                cerr << "Error: invalid pipeline depth " << argv[i] << endl;
+                return false;
+            }
+        }
+        else
+        {
+            cerr << "Error: unknown option " << arg << endl;
+            printUsage(argv[0]);
+            return false;
+        }
+    }
+    if (options.functional && (options.ffInstrs >= 0 || options.ffPC >= 0))
+    {
+        cerr << "Error: --ff/--ff-pc cannot be combined with --functional" << endl;
+        return false;
+    }
+    if (!ValidPredictorConfig(options.predictor))
+    {
+        cerr << "Error: unknown branch predictor or predictor table size not a power of two" << endl;
+        return false;
+    }
+    if (!ValidPrefetchConfig(options.caches.prefetch) || (options.caches.prefetch.kind != "none" && options.caches.l1d.size == 0))
+    {
+        cerr << "Error: unknown prefetcher, invalid prefetcher size, or prefetcher without --l1d" << endl;
+        return false;
+    }
+    if (options.muldiv.mulLatency < 1 || options.muldiv.divLatency < 1)
+    {
+        cerr << "Error: --mul-latency and --div-latency must be at least 1" << endl;
+        return false;
+    }
+    if (options.width < 1 || options.width > 8)
+    {
+        cerr << "Error: --width must be between 1 and 8" << endl;
+        return false;
+    }
+    if (!ValidOutOfOrderConfig(options.ooo))
+    {
+        cerr << "Error: --rob, --rs and --lsq must be at least 1" << endl;
+        return false;
+    }
+    if (options.outOfOrder && !options.depth.IsDefault())
+    {
+        cerr << "Error: --depth applies to the in-order pipeline, not --ooo" << endl;
+        return false;
+    }
+    if (!options.checkpointFile.empty() || !options.restoreFile.empty())
+    {
+        if (options.functional || options.outOfOrder || options.width > 1 || !options.depth.IsDefault())
+        {
+            cerr << "Error: checkpoints are only taken of the 5-stage pipeline" << endl;
+            return false;
+        }
+        if (!options.restoreFile.empty() && (options.ffInstrs >= 0 || options.ffPC >= 0))
+        {
+            cerr << "Error: --restore cannot be combined with --ff/--ff-pc" << endl;
+            return false;
+        }
+    }
+    if (options.sample.interval < 0 || options.sample.clusters < 1 || options.sample.perCluster < 1 || options.sample.warmup < 0)
+    {
+        cerr << "Error: invalid sampling parameters" << endl;
+        return false;
+    }
+    if (options.sample.interval > 0 &&
+        (options.functional || options.ffInstrs >= 0 || options.ffPC >= 0 || !options.checkpointFile.empty() ||
+         !options.restoreFile.empty() || options.outOfOrder || options.width > 1 || !options.depth.IsDefault()))
+    {
+        cerr << "Error: --sample runs the 5-stage pipeline and cannot be combined with --functional, --ff, checkpoints or other cores" << endl;
+        return false;
+    }
+    if ((!options.cpiStackFile.empty() || options.profile) &&
+        (options.functional || options.sample.interval > 0 || options.outOfOrder || options.width > 1 || !options.depth.IsDefault()))
+    {
+        cerr << "Error: --cpi-stack and --profile attribute the cycles of the 5-stage pipeline and cannot be combined with --functional, --sample or other cores" << endl;
+        return false;
+    }
+    if ((!options.traceFile.empty() || !options.kanataFile.empty()) && (options.functional || options.sample.interval > 0 || options.outOfOrder))
+    {
+        cerr << "Error: --trace and --kanata need one instruction per stage and slot: the 5-stage or --width pipeline, without --functional or --sample" << endl;
+        return false;
+    }
+    if (!options.binTraceFile.empty() && (options.functional || options.sample.interval > 0))
+    {
+        cerr << "Error: --trace-bin records the pipeline diagram and cannot be combined with --functional or --sample" << endl;
+        return false;
+    }
+    if (options.checkpointEvery < 0 || (options.checkpointEvery > 0 && options.checkpointFile.empty()))
+    {
+        cerr << "Error: --checkpoint-every needs --checkpoint and a positive interval" << endl;
+        return false;
+    }
+    return true;
+}
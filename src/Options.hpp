@@ -0,0 +1,51 @@
+#ifndef OPTIONS_HPP
+#define OPTIONS_HPP
+
+#include <string>
+#include "BranchPredictor.hpp"
+#include "Cache.hpp"
+#include "Processor.hpp"
+#include "OutOfOrder.hpp"
+#include "Superscalar.hpp"
+#include "Sampling.hpp"
+
+// Command line of the forward / noforward simulators:
+//   <input.txt> <num_cycles> [--functional] [--ff N] [--ff-pc P]
+//   [--bp KIND] [--bp-entries N] [--bp-history H] [--btb N] [--ras N]
+//   [--l1i SPEC] [--l1d SPEC] [--l2 SPEC] [--mem-latency N]
+//   [--prefetch KIND] [--prefetch-degree N] [--prefetch-entries N]
+//   [--mul-latency N] [--div-latency N] [--width N]
+//   [--ooo] [--rob N] [--rs N] [--lsq N] [--depth SPEC]
+//   [--checkpoint FILE] [--checkpoint-every N] [--restore FILE]
+//   [--sample N] [--sample-clusters K] [--sample-per-cluster N] [--sample-warmup N]
+//   [--cpi-stack FILE] [--profile] [--trace FILE] [--kanata FILE]
+//   [--trace-bin FILE]
+struct SimOptions
+{
+    std::string inputFile;
+    long numCycles;  // Cycle budget (instruction budget with --functional)
+    bool functional; // Architectural execution only, no pipeline timing
+    long ffInstrs;   // Fast-forward this many instructions before the timed region (-1 = no limit)
+    int ffPC;        // Fast-forward until this instruction index is reached, within ffInstrs if set (-1 = none)
+    PredictorConfig predictor;
+    MemoryConfig caches;
+    MulDivConfig muldiv;
+    int width; // Instructions per cycle; above 1 (or with depth) the superscalar core is used
+    bool outOfOrder; // Run the out-of-order core (width is its fetch/dispatch/commit width)
+    OutOfOrderConfig ooo;
+    PipelineDepth depth; // Stages of the in-order pipeline
+    std::string checkpointFile; // Snapshot written after the last cycle ("" = none)
+    long checkpointEvery;       // Also rewrite it every this many cycles (0 = only at the end)
+    std::string restoreFile;    // Snapshot to resume from ("" = start from reset)
+    SampleConfig sample;        // With sample.interval, num_cycles is the profiling instruction budget
+    std::string cpiStackFile;   // Stall attribution written after the run, JSON if it ends in .json, else CSV ("" = none)
+    bool profile;               // Write the per-instruction hot-PC profile (<input>_<mode>_profile_out.txt)
+    std::string traceFile;      // Chrome trace-event JSON streamed during the run ("" = none)
+    std::string kanataFile;     // Kanata log for Konata streamed during the run ("" = none)
+    std::string binTraceFile;   // Binary diagram records written instead of the diagram file ("" = none)
+};
+
+// Returns false (after printing usage) when the arguments are invalid
+bool ParseOptions(int argc, char **argv, SimOptions &options);
+
+#endif
@@ -0,0 +1,255 @@
+#include "OutOfOrder.hpp"
+#include <climits>
+#include <vector>
+using namespace std;
+
+bool ValidOutOfOrderConfig(const OutOfOrderConfig &config)
+{
+    return config.robEntries >= 1 && config.rsEntries >= 1 && config.lsqEntries >= 1;
+}
+
+OutOfOrderCore::OutOfOrderCore(const vector<DecodedInstr> &program, int width, const OutOfOrderConfig &config, bool bypass)
+    : TimingCore(program, width), config(config), bypass(bypass), headSeq(0), nextSeq(0), committedNow(0),
+      dispatchStalled(false), robFull(0), rsFull(0), lsqFull(0), loads(0), loadsForwarded(0)
+{
+    for (int i = 0; i < 32; i++)
+        rat[i] = -1;
+}
+
+void OutOfOrderCore::Cycle()
+{
+    now++;
+    commit();
+    issue();
+    dispatch();
+    process_IF();
+}
+
+bool OutOfOrderCore::Busy() const
+{
+    return committedNow > 0 || !rob.empty() || !decoded.empty() || !fetched.empty();
+}
+
+// Oldest first, so of several copies of one instruction in flight the
+// youngest shows, and IF wins as in RunPipeline
+void OutOfOrderCore::Record(PipelineDiagram &diagram, int cycle) const
+{
+    for (size_t i = timeline.size() - committedNow; i < timeline.size(); i++)
+        diagram.Record(cycle, timeline[i].InStr, 5);
+    for (const Entry &e : rob)
+    {
+        int stage;
+        if (e.issued < 0)
+            stage = 2;
+        else if (now > e.completed)
+            stage = 5;
+        else if (program[e.op.InStr].MemRead && now >= e.memStart)
+            stage = 4;
+        else
+            stage = 3;
+        diagram.Record(cycle, e.op.InStr, stage);
+    }
+    for (const Op &op : decoded)
+        diagram.Record(cycle, op.InStr, 2);
+    RecordFetch(diagram, cycle);
+}
+
+void OutOfOrderCore::Report(ostream &out) const
+{
+    out << "Out-of-order: " << config.robEntries << "-entry ROB, " << config.rsEntries << " RS entries per unit, "
+        << config.lsqEntries << "-entry LSQ; dispatch stalled " << robFull << " cycles on the ROB, " << rsFull
+        << " on a reservation station, " << lsqFull << " on the LSQ; " << loadsForwarded << " of " << loads
+        << " loads forwarded from a store" << endl;
+}
+
+void OutOfOrderCore::WriteTimeline(ostream &out, const vector<string> &labels) const
+{
+    out << "instruction;fetch;dispatch;issue;complete;commit\n";
+    for (const Committed &c : timeline)
+    {
+        out << ((c.InStr < (int)labels.size()) ? labels[c.InStr] : "") << ';' << c.fetched - 1 << ';' << c.dispatched - 1
+            << ';' << c.issued - 1 << ';' << c.completed - 1 << ';' << c.committed - 1 << '\n';
+    }
+}
+
+bool OutOfOrderCore::sourceReady(long seq) const
+{
+    // No writer in flight when it was renamed, or it has committed since
+    if (seq < headSeq)
+        return true;
+    return rob[seq - headSeq].readyAt <= now;
+}
+
+// Memory ordering for load: every older store must have issued (its address
+// is known). forwarded is set when the youngest older store that overlaps
+// the load supplies all of its bytes; one that overlaps only in part makes
+// the load wait until it has committed and left the queue.
+bool OutOfOrderCore::loadCanIssue(const Entry &load, bool &forwarded) const
+{
+    const DecodedInstr &instr = program[load.op.InStr];
+    uint32_t begin = load.op.out.address;
+    uint32_t end = begin + instr.MemSize;
+    const Entry *source = nullptr;
+    for (long seq : lsq)
+    {
+        if (seq >= load.seq)
+            break;
+        const Entry &e = rob[seq - headSeq];
+        const DecodedInstr &older = program[e.op.InStr];
+        if (!older.MemWrite)
+            continue;
+        if (e.issued < 0)
+            return false;
+        uint32_t storeBegin = e.op.out.address;
+        uint32_t storeEnd = storeBegin + older.MemSize;
+        if (begin < storeEnd && storeBegin < end)
+            source = &e;
+    }
+    if (!source)
+        return true;
+    const DecodedInstr &store = program[source->op.InStr];
+    uint32_t storeBegin = source->op.out.address;
+    forwarded = storeBegin <= begin && end <= storeBegin + store.MemSize;
+    return forwarded;
+}
+
+// Retire completed instructions from the ROB head in program order
+void OutOfOrderCore::commit()
+{
+    committedNow = 0;
+    while (committedNow < width && !rob.empty())
+    {
+        const Entry &e = rob.front();
+        if (e.issued < 0 || e.completed >= now)
+            break;
+        const DecodedInstr &instr = program[e.op.InStr];
+        // The store leaves through a write buffer; its latency is hidden
+        if (instr.MemWrite && dcache)
+            dcache->Access(e.op.out.address, true, now, e.op.InStr);
+        if (instr.MemRead || instr.MemWrite)
+            lsq.pop_front();
+        if (instr.RegWrite && instr.WR != 0 && rat[instr.WR] == e.seq)
+            rat[instr.WR] = -1;
+        timeline.push_back({e.op.InStr, e.op.fetchedAt, e.dispatched, e.issued, e.completed, now});
+        rob.pop_front();
+        headSeq++;
+        committedNow++;
+    }
+}
+
+// Start the oldest ready entries of every reservation station
+void OutOfOrderCore::issue()
+{
+    const int ports[NUM_UNITS] = {width, 1, 1};
+    for (int unit = 0; unit < NUM_UNITS; unit++)
+    {
+        vector<long> &station = rs[unit];
+        int started = 0;
+        for (size_t i = 0; i < station.size() && started < ports[unit];)
+        {
+            Entry &e = entry(station[i]);
+            const DecodedInstr &instr = program[e.op.InStr];
+            bool forwarded = false;
+            bool divide = (unit == UNIT_MULDIV && IsDivide(instr.ALUOp));
+            if (!sourceReady(e.src[0]) || !sourceReady(e.src[1]) || (instr.MemRead && !loadCanIssue(e, forwarded)) ||
+                (divide && divFreeAt > now))
+            {
+                i++;
+                continue;
+            }
+
+            long latency = 1;
+            if (unit == UNIT_MULDIV)
+            {
+                latency = divide ? muldiv.divLatency : muldiv.mulLatency;
+                if (divide)
+                    divFreeAt = now + latency;
+            }
+            else if (instr.MemRead)
+            {
+                // Address this cycle, then the L1D (or the store's data)
+                e.memStart = now + 1;
+                loads++;
+                if (forwarded)
+                    loadsForwarded++;
+                latency = 1 + ((dcache && !forwarded) ? dcache->Access(e.op.out.address, false, now + 1, e.op.InStr) : 1);
+            }
+            e.issued = now;
+            e.completed = now + latency - 1;
+            e.readyAt = e.completed + (bypass ? 1 : 2);
+            if (IsControl(instr))
+                resolve(e.op, instr, e.completed + 1);
+
+            station.erase(station.begin() + i);
+            started++;
+        }
+    }
+}
+
+// Rename the ID group into the ROB, reservation stations and LSQ in program
+// order, then refill ID from IF
+void OutOfOrderCore::dispatch()
+{
+    dispatchStalled = false;
+    size_t taken = 0;
+    for (; taken < decoded.size(); taken++)
+    {
+        const Op &op = decoded[taken];
+        const DecodedInstr &instr = program[op.InStr];
+        bool memory = instr.MemRead || instr.MemWrite;
+        Unit unit = memory                                                                                 ? UNIT_MEM
+                    : (instr.Class == CLASS_ALU && (IsMultiply(instr.ALUOp) || IsDivide(instr.ALUOp))) ? UNIT_MULDIV
+                                                                                                        : UNIT_ALU;
+        long *full = (rob.size() >= (size_t)config.robEntries)             ? &robFull
+                     : (rs[unit].size() >= (size_t)config.rsEntries)       ? &rsFull
+                     : (memory && lsq.size() >= (size_t)config.lsqEntries) ? &lsqFull
+                                                                           : nullptr;
+        if (full)
+        {
+            (*full)++;
+            dispatchStalled = true;
+            break;
+        }
+
+        Entry e;
+        e.op = op;
+        e.seq = nextSeq++;
+        e.src[0] = (instr.RR1 > 0) ? rat[instr.RR1] : -1;
+        e.src[1] = (instr.RR2 > 0) ? rat[instr.RR2] : -1;
+        e.dispatched = now;
+        e.issued = -1;
+        e.memStart = -1;
+        e.completed = -1;
+        e.readyAt = LONG_MAX;
+        if (instr.RegWrite && instr.WR != 0)
+            rat[instr.WR] = e.seq;
+        rob.push_back(e);
+        rs[unit].push_back(e.seq);
+        if (memory)
+            lsq.push_back(e.seq);
+    }
+    decoded.erase(decoded.begin(), decoded.begin() + taken);
+
+    size_t moved = 0;
+    while (moved < fetched.size() && decoded.size() < (size_t)width)
+        decoded.push_back(fetched[moved++]);
+    fetched.erase(fetched.begin(), fetched.begin() + moved);
+}
+
+RunStats RunPipeline(OutOfOrderCore &cpu, PipelineDiagram &diagram, int numCycles, const CycleHook &afterCycle)
+{
+    RunStats stats = {0, 0, 0};
+    for (int cycle = 0; cycle < numCycles; cycle++)
+    {
+        cpu.Cycle();
+        cpu.Record(diagram, cycle);
+        stats.retired += cpu.Retired();
+        if (cpu.DispatchStalled())
+            stats.stalls++;
+        if (cpu.Busy())
+            stats.cycles = cycle + 1;
+        if (afterCycle)
+            afterCycle(cycle + 1);
+    }
+    return stats;
+}
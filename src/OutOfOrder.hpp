@@ -0,0 +1,122 @@
+#ifndef OUT_OF_ORDER_HPP
+#define OUT_OF_ORDER_HPP
+
+#include <deque>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "TimingCore.hpp"
+#include "PipelineDiagram.hpp"
+#include "Simulation.hpp"
+
+// Buffer sizes of the out-of-order core
+struct OutOfOrderConfig
+{
+    int robEntries = 32; // Reorder buffer
+    int rsEntries = 8;   // Reservation station entries per unit class (ALU, MUL/DIV, memory)
+    int lsqEntries = 16; // Load/store queue
+};
+
+// Returns false if a size is below 1
+bool ValidOutOfOrderConfig(const OutOfOrderConfig &config);
+
+// Tomasulo-style core behind the TimingCore front end. Each cycle:
+//   commit   retires up to `width` completed instructions from the head of
+//            the reorder buffer in program order; stores write the L1D here
+//   issue    starts the oldest ready entries of each reservation station:
+//            `width` ALUs, one multiplier/divider port (divisions wait for
+//            the divider) and one memory port
+//   dispatch renames up to `width` decoded instructions through the register
+//            alias table into the ROB, their reservation station and, for
+//            loads/stores, the load/store queue; in order, stopping at the
+//            first one that does not fit
+//   decode   moves the IF group into ID
+// A result can be used the cycle after it completes (two with noforward,
+// where it has to go through RegFile). A load issues once every older store
+// knows its address; it takes its data from the youngest older store that
+// covers it (no L1D access), waits for that store to commit if the store
+// covers it only in part, and reads the L1D otherwise. Branches and jumps
+// resolve when they execute.
+class OutOfOrderCore : public TimingCore
+{
+public:
+    OutOfOrderCore(const std::vector<DecodedInstr> &program, int width, const OutOfOrderConfig &config, bool bypass);
+
+    // Advance one clock cycle
+    void Cycle();
+
+    // Mark every instruction in flight this cycle in diagram: ID while it
+    // waits in a reservation station, EX, MEM for a load's memory cycles
+    // and WB from completion until it commits
+    void Record(PipelineDiagram &diagram, int cycle) const;
+
+    // Instructions committed this cycle
+    int Retired() const { return committedNow; }
+    // Dispatch could not accept the oldest decoded instruction this cycle
+    bool DispatchStalled() const { return dispatchStalled; }
+    // Any instruction is in flight
+    bool Busy() const;
+
+    // Buffer sizes, dispatch stalls and store-to-load forwarding
+    void Report(std::ostream &out) const;
+    // One line per committed instruction with the cycles (diagram columns)
+    // it was fetched, dispatched, issued, completed and committed in
+    void WriteTimeline(std::ostream &out, const std::vector<std::string> &labels) const;
+
+private:
+    enum Unit
+    {
+        UNIT_ALU,
+        UNIT_MULDIV,
+        UNIT_MEM,
+        NUM_UNITS
+    };
+
+    struct Entry
+    {
+        Op op;
+        long seq;       // Program order of in-flight instructions
+        long src[2];    // ROB entry producing rs1 / rs2, -1 if it comes from RegFile
+        long dispatched;
+        long issued;    // -1 until issued
+        long memStart;  // First memory cycle of a load
+        long completed; // Last execution cycle, -1 until issued
+        long readyAt;   // First cycle a consumer may issue, LONG_MAX until issued
+    };
+
+    struct Committed
+    {
+        int InStr;
+        long fetched, dispatched, issued, completed, committed;
+    };
+
+    OutOfOrderConfig config;
+    bool bypass;
+
+    std::vector<Op> decoded;     // ID, oldest first
+    std::deque<Entry> rob;       // Oldest first
+    long headSeq;                // seq of rob.front()
+    long nextSeq;
+    long rat[32];                // Youngest in-flight writer of each register, -1 if none
+    std::vector<long> rs[NUM_UNITS]; // Entries waiting to issue, oldest first
+    std::deque<long> lsq;        // Loads and stores in program order
+
+    std::vector<Committed> timeline;
+    int committedNow;
+    bool dispatchStalled;
+    long robFull, rsFull, lsqFull; // Dispatch stall cycles by cause
+    long loads, loadsForwarded;
+
+    Entry &entry(long seq) { return rob[seq - headSeq]; }
+    bool sourceReady(long seq) const;
+    bool loadCanIssue(const Entry &load, bool &forwarded) const;
+
+    void commit();
+    void issue();
+    void dispatch();
+};
+
+// RunPipeline for the out-of-order core: numCycles cycles, all recorded
+RunStats RunPipeline(OutOfOrderCore &cpu, PipelineDiagram &diagram, int numCycles, const CycleHook &afterCycle = CycleHook());
+
+#endif
@@ -0,0 +1,75 @@
+#ifndef PARALLEL_FOR_HPP
+#define PARALLEL_FOR_HPP
+
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Run body(i) for every i in [0, count) on `threads` workers.
+// Tasks are dealt round-robin into one deque per worker. A worker takes
+// from the back of its own deque and, once that is empty, steals from the
+// front of the others. Long jobs (big programs, large cycle budgets) then
+// do not leave the remaining workers idle.
+template <typename Body>
+void ParallelFor(size_t count, unsigned threads, Body body)
+{
+    if (threads == 0)
+        threads = 1;
+    if (threads > count)
+        threads = count ? count : 1;
+
+    struct WorkQueue
+    {
+        std::mutex lock;
+        std::deque<size_t> tasks;
+    };
+    std::vector<std::unique_ptr<WorkQueue>> queues;
+    for (unsigned t = 0; t < threads; t++)
+        queues.emplace_back(new WorkQueue());
+    for (size_t i = 0; i < count; i++)
+        queues[i % threads]->tasks.push_back(i);
+
+    auto worker = [&](unsigned self) {
+        for (;;)
+        {
+            size_t task;
+            bool found = false;
+            {
+                std::lock_guard<std::mutex> guard(queues[self]->lock);
+                if (!queues[self]->tasks.empty())
+                {
+                    task = queues[self]->tasks.back();
+                    queues[self]->tasks.pop_back();
+                    found = true;
+                }
+            }
+            for (unsigned k = 1; !found && k < threads; k++)
+            {
+                WorkQueue &victim = *queues[(self + k) % threads];
+                std::lock_guard<std::mutex> guard(victim.lock);
+                if (!victim.tasks.empty())
+                {
+                    task = victim.tasks.front();
+                    victim.tasks.pop_front();
+                    found = true;
+                }
+            }
+            // No task is ever added after the start, so all queues empty means done
+            if (!found)
+                return;
+            body(task);
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < threads; t++)
+        pool.emplace_back(worker, t);
+    worker(0);
+    for (std::thread &thread : pool)
+        thread.join();
+}
+
+#endif
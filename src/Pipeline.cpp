@@ -0,0 +1,359 @@
+#include "Pipeline.hpp"
+#include "Execute.hpp"
+#include <algorithm>
+using namespace std;
+
+template <typename Policy>
+void Pipeline<Policy>::process_ID()
+{
+    if (ID.stall)
+    {
+        // cout << "ID stage stalled; holding instruction " << ID.InStr << endl;
+        ID.stall = false;
+        IF.stall = true;
+        bubble(program[IF.InStr].Class == CLASS_JALR ? STALL_JALR_OPERAND : STALL_BRANCH_OPERAND, IF.InStr);
+        return;
+    }
+    if (IF.InStr == -1 || IF.InStr >= (int)program.size())
+    {
+        ID.InStr = -1;
+        if (IF.InStr == -1)
+            bubble(fetchBubble, fetchBubbleInstr);
+        else
+            bubble(STALL_EMPTY, -1);
+        return;
+    }
+    if (IF.branch == 2 || IF.branch == 3)
+    {
+        ID.InStr = -1;
+        bubble(fetchBubble, fetchBubbleInstr);
+        return;
+    }
+    // Operands from the multiplier/divider are bypassed once they are done
+    StallReason mulDivStall = mulDivHazard(program[IF.InStr]);
+    if (mulDivStall != STALL_NONE)
+    {
+        ID.InStr = -1;
+        IF.stall = true;
+        bubble(mulDivStall, IF.InStr);
+        return;
+    }
+    ID.InStr = IF.InStr;
+    slotReason = STALL_NONE;
+    slotInstr = ID.InStr;
+
+    Decoder(program[ID.InStr]);
+
+    if constexpr (Policy::BYPASS_EX)
+    {
+        // A load result only reaches the bypass a cycle after EX needs it
+        bool loadHazard = false;
+        if (EX.RegWrite && EX.MemtoReg)
+        {
+            if (EX.WriteReg == ID.RR1 || (!ID.ALUSrc && EX.WriteReg == ID.RR2))
+            {
+                loadHazard = true;
+            }
+        }
+
+        if (loadHazard)
+        {
+            // A branch or JALR Decoder already holds keeps its own reason
+            if (ID.InStr != -1)
+                bubble(STALL_LOAD_USE, IF.InStr);
+            ID.InStr = -1;
+            IF.stall = true;
+            return;
+        }
+    }
+}
+
+template <typename Policy>
+bool Pipeline<Policy>::waitForRegFile(StallReason reason)
+{
+    if ((EX.RegWrite && (ID.RR1 == EX.WriteReg || ID.RR2 == EX.WriteReg)) || (DM.RegWrite && (ID.RR1 == DM.WriteReg || ID.RR2 == DM.WriteReg)))
+    {
+        ID.InStr = -1;
+        IF.stall = true;
+        bubble(reason, IF.InStr);
+        return true;
+    }
+    return false;
+}
+
+template <typename Policy>
+void Pipeline<Policy>::Decoder(const DecodedInstr &instr)
+{
+    bool temp = false;
+    // Unsupported encodings leave the previous control signals in ID
+    if (instr.Class != CLASS_UNKNOWN)
+        ApplyDecoded(ID, instr);
+
+    // B-type: Branch instructions
+    if (instr.Class == CLASS_BRANCH)
+    {
+        int arg1 = RegFile[ID.RR1].value, arg2 = RegFile[ID.RR2].value;
+
+        if constexpr (Policy::BYPASS_ID)
+        {
+            if (EX.RegWrite && (EX.WriteReg == ID.RR1 || EX.WriteReg == ID.RR2) && !EX.MemtoReg) // forward last ALU one stall
+            {
+                ID.ALU_stall_prev = true;
+                IF.stall = true;
+                ID.InStr = -1;
+                bubble(STALL_BRANCH_OPERAND, IF.InStr);
+                return;
+            }
+            if (EX.RegWrite && (EX.WriteReg == ID.RR1 || EX.WriteReg == ID.RR2) && EX.MemtoReg) // forawrd last DM two stall
+            {
+                ID.DM_stall_prev = 1; // used at top in id.stall
+                ID.stall = true;
+                IF.stall = true;
+                ID.InStr = -1;
+                bubble(STALL_BRANCH_OPERAND, IF.InStr);
+                return;
+            }
+            if (DM.RegWrite && (DM.WriteReg == ID.RR1 || DM.WriteReg == ID.RR2) && !DM.MemtoReg) // forward last to last instr ALU, no stall
+            {
+                if (DM.WriteReg == ID.RR1)
+                    arg1 = DM.ALU_res;
+                else
+                    arg2 = DM.ALU_res;
+            }
+            if (DM.RegWrite && (DM.WriteReg == ID.RR1 || DM.WriteReg == ID.RR2) && DM.MemtoReg) // forward last to last DM, one stall
+            {
+                ID.DM_stall_prev2 = true;
+                IF.stall = true;
+                ID.InStr = -1;
+                bubble(STALL_BRANCH_OPERAND, IF.InStr);
+                return;
+            }
+
+            if (ID.ALU_stall_prev)
+            {
+                if (DM.WriteReg == ID.RR1)
+                    arg1 = DM.ALU_res;
+                else
+                    arg2 = DM.ALU_res;
+                ID.ALU_stall_prev = false;
+            }
+            if (ID.DM_stall_prev2)
+            {
+                if (DM.WriteReg == ID.RR1)
+                    arg1 = WB.Read_data;
+                else
+                    arg2 = WB.Read_data;
+                ID.DM_stall_prev2 = false;
+            }
+            if (ID.DM_stall_prev == 1)
+            {
+                if (WB.WriteReg == ID.RR1)
+                    arg1 = WB.Read_data;
+                else
+                    arg2 = WB.Read_data;
+                ID.DM_stall_prev = 0;
+            }
+        }
+        else if (waitForRegFile(STALL_BRANCH_OPERAND))
+            return;
+
+        bool taken = BranchTaken(ID.BranchType, arg1, arg2);
+        if (predictor)
+        {
+            // IF already fetched down the predicted path; redirect only on a miss
+            predictor->Resolve(ID.InStr, taken, IF.predicted);
+            if (taken != IF.predicted)
+            {
+                IF.branch = 1;
+                IF.branchPC = taken ? ID.InStr + ID.Imm / 4 : ID.InStr + 1;
+            }
+        }
+        else
+        {
+            IF.branch = taken;
+            if (IF.branch == 1)
+                IF.branchPC = IF.PC + (ID.Imm / 4) - 1;
+        }
+    }
+    // J-type: JAL (Jump and Link)
+    else if (instr.Class == CLASS_JAL)
+    {
+        int target = ID.InStr + ID.Imm / 4; // Jump target (instruction index)
+        if (btb)
+            btb->Update(ID.InStr, target, IF.predictedTarget);
+        if (IF.predictedTarget == -1 || IF.predictedTarget != target) // -1: not predicted
+        {
+            IF.branchPC = target;
+            IF.branch = 1;
+        }
+
+        temp = true; // for WB write
+    }
+    // I-type: JALR (Jump and Link Register)
+    else if (instr.Class == CLASS_JALR)
+    {
+        int arg1 = RegFile[ID.RR1].value;
+
+        if constexpr (Policy::BYPASS_ID)
+        {
+            if (EX.RegWrite && (EX.WriteReg == ID.RR1) && !EX.MemtoReg) // forward last ALU one stall
+            {
+                ID.ALU_stall_prev = true;
+                IF.stall = true;
+                ID.InStr = -1;
+                bubble(STALL_JALR_OPERAND, IF.InStr);
+                return;
+            }
+            if (EX.RegWrite && (EX.WriteReg == ID.RR1) && EX.MemtoReg) // forawrd last DM two stall
+            {
+                ID.DM_stall_prev = 1; // used at top in id.stall
+                ID.stall = true;
+                IF.stall = true;
+                ID.InStr = -1;
+                bubble(STALL_JALR_OPERAND, IF.InStr);
+                return;
+            }
+            if (DM.RegWrite && (DM.WriteReg == ID.RR1) && !DM.MemtoReg) // forward last to last instr ALU, no stall
+            {
+                arg1 = DM.ALU_res;
+            }
+            if (DM.RegWrite && (DM.WriteReg == ID.RR1) && DM.MemtoReg) // forward last to last DM, one stall
+            {
+                ID.DM_stall_prev2 = true;
+                IF.stall = true;
+                ID.InStr = -1;
+                bubble(STALL_JALR_OPERAND, IF.InStr);
+                return;
+            }
+
+            if (ID.ALU_stall_prev)
+            {
+                arg1 = DM.ALU_res;
+                ID.ALU_stall_prev = false;
+            }
+            if (ID.DM_stall_prev2)
+            {
+                arg1 = WB.Read_data;
+                ID.DM_stall_prev2 = false;
+            }
+            if (ID.DM_stall_prev == 1)
+            {
+                arg1 = WB.Read_data;
+                ID.DM_stall_prev = 0;
+            }
+        }
+        else if (waitForRegFile(STALL_JALR_OPERAND))
+            return;
+
+        int target = (arg1 + ID.Imm) / 4; // Jump target
+        if (IF.fromRAS)
+            ras->Resolve(IF.predictedTarget == target);
+        else if (btb)
+            btb->Update(ID.InStr, target, IF.predictedTarget);
+        if (IF.predictedTarget == -1 || IF.predictedTarget != target) // -1: not predicted
+        {
+            IF.branchPC = target;
+            IF.branch = 1;
+        }
+
+        temp = true; // rd gets the return index, as for JAL
+    }
+    // Without a bypass into EX every instruction waits for its operands here
+    if constexpr (!Policy::BYPASS_EX)
+        waitForRegFile(STALL_RAW);
+
+    ID.RD1 = RegFile[max(0, ID.RR1)].value;
+    ID.RD2 = RegFile[max(0, ID.RR2)].value;
+    if (temp)
+    { // wb of jal jalr
+        ID.Imm = 0;
+        ID.RD1 = ID.InStr + 1; // IF.PC, unless fetch already jumped to the target
+    }
+    if (ID.WR == 0)
+        ID.RegWrite = false;
+}
+
+template <typename Policy>
+void Pipeline<Policy>::process_EX()
+{
+    if (ID.InStr == -1 || ID.stall)
+    {
+        EX.InStr = -1;
+        EX.MemRead = false;
+        EX.MemWrite = false;
+        EX.RegWrite = false;
+        EX.MemtoReg = false;
+        EX.Branch = false;
+        EX.Jump = false;
+
+        return;
+    }
+    // bool loadHazard = false;
+    // if (DM.RegWrite && DM.MemtoReg)
+    // {
+    //     if (DM.WriteReg == ID.RR1 || (!ID.ALUSrc && DM.WriteReg == ID.RR2))
+    //     {
+    //         loadHazard = true;
+    //     }
+    // }
+
+    // if (loadHazard)
+    // {
+    //     EX.InStr = -1;
+    //     ID.stall = true;
+    //     return;
+    // }
+
+    EX.InStr = ID.InStr;
+    EX.WriteReg = ID.WR;
+    EX.Branch = ID.Branch;
+    EX.Jump = ID.Jump;
+    EX.MemRead = ID.MemRead;
+    EX.MemWrite = ID.MemWrite;
+    EX.MemtoReg = ID.MemtoReg;
+    EX.RegWrite = ID.RegWrite;
+    EX.WriteData = ID.RD2;
+    EX.WriteDataReg = ID.RR2;
+
+    EX.MemSize = ID.MemSize;
+    EX.MemSignExtend = ID.MemSignExtend;
+
+    if constexpr (Policy::BYPASS_EX)
+    {
+        if (EX.MemWrite == true)
+        {
+            if (WB.RegWrite == true && WB.WriteReg == EX.WriteDataReg)
+            {
+                if (WB.MemtoReg == true)
+                    EX.WriteData = WB.Read_data;
+                else
+                    EX.WriteData = WB.ALU_res;
+            }
+        }
+    }
+
+    int arg1 = ID.RD1;
+    int arg2 = ID.ALUSrc ? ID.Imm : ID.RD2;
+    if constexpr (Policy::BYPASS_EX)
+    {
+        if (DM.RegWrite && DM.WriteReg == ID.RR1)
+            arg1 = (DM.MemtoReg ? DM.Read_data : DM.ALU_res);
+        else if (WB.RegWrite && WB.WriteReg == ID.RR1)
+            arg1 = (WB.MemtoReg ? WB.Read_data : WB.ALU_res);
+
+        if (!ID.ALUSrc)
+        {
+            if (DM.RegWrite && DM.WriteReg == ID.RR2)
+                arg2 = (DM.MemtoReg ? DM.Read_data : DM.ALU_res);
+            else if (WB.RegWrite && WB.WriteReg == ID.RR2)
+                arg2 = (WB.MemtoReg ? WB.Read_data : WB.ALU_res);
+        }
+    }
+    EX.ALU_res = ALUCompute(ID.ALUOp, arg1, arg2);
+    EX.Zero = (EX.ALU_res == 0);
+    issueMulDiv(ID.ALUOp, ID.WR, ID.RegWrite);
+}
+
+template class Pipeline<FullForwarding>;
+template class Pipeline<NoForwarding>;
+template class Pipeline<EXBypassOnly>;
@@ -0,0 +1,96 @@
+#ifndef PIPELINE_HPP
+#define PIPELINE_HPP
+
+#include <vector>
+#include "Processor.hpp"
+#include "Predecode.hpp"
+
+// Hazard/forwarding policies. Each is a set of compile-time constants, so
+// Pipeline<Policy> compiles the per-cycle hazard checks of the chosen
+// policy only, with no run-time switches.
+//
+//   BYPASS_EX     results in MEM/WB are bypassed into EX (ALU operands and
+//                 store data); only a load directly ahead of its consumer
+//                 stalls. Without it, ID waits until every source operand
+//                 is back in RegFile.
+//   BYPASS_ID     branch/JALR operands are also bypassed into ID, where
+//                 branches resolve. Without it, they wait for RegFile.
+//   DRAIN_CYCLES  cycles clocked after the budget so the last instructions
+//                 drain (not rendered in the diagram).
+
+// Full forwarding: the ./forward build
+struct FullForwarding
+{
+    static const bool BYPASS_EX = true;
+    static const bool BYPASS_ID = true;
+    static const int DRAIN_CYCLES = 3;
+};
+
+// No forwarding: the ./noforward build
+struct NoForwarding
+{
+    static const bool BYPASS_EX = false;
+    static const bool BYPASS_ID = false;
+    static const int DRAIN_CYCLES = 0;
+};
+
+// Bypass into EX only; branches and JALR wait in ID for RegFile
+struct EXBypassOnly
+{
+    static const bool BYPASS_EX = true;
+    static const bool BYPASS_ID = false;
+    static const int DRAIN_CYCLES = 0;
+};
+
+// 5-stage pipeline whose ID and EX stages follow Policy
+template <typename Policy>
+class Pipeline : public Processor
+{
+    static_assert(Policy::BYPASS_EX || !Policy::BYPASS_ID, "bypassing into ID requires bypassing into EX");
+
+public:
+    static const bool BYPASS_EX = Policy::BYPASS_EX;
+    static const bool BYPASS_ID = Policy::BYPASS_ID;
+    static const int DRAIN_CYCLES = Policy::DRAIN_CYCLES;
+
+    explicit Pipeline(const std::vector<DecodedInstr> &program) : Processor(program) {}
+
+    // Advance one clock cycle
+    void Cycle()
+    {
+        now++;
+        // Waiting on a data cache miss: nothing moves and WB sees bubbles
+        if (memStall > 0)
+        {
+            memStall--;
+            bubbleWB();
+            bubble(STALL_DCACHE, DM.InStr);
+            return;
+        }
+        process_WB();
+        process_MEM();
+        process_EX();
+        process_ID();
+        process_IF();
+    }
+
+private:
+    void process_ID();
+    void process_EX();
+    void Decoder(const DecodedInstr &instr);
+
+    // True (after inserting a bubble charged to reason) if rs1/rs2 are
+    // still being produced in EX or MEM
+    bool waitForRegFile(StallReason reason);
+};
+
+typedef Pipeline<FullForwarding> Processor_F;
+typedef Pipeline<NoForwarding> Processor_NF;
+typedef Pipeline<EXBypassOnly> Processor_EXB;
+
+// Instantiated once in Pipeline.cpp
+extern template class Pipeline<FullForwarding>;
+extern template class Pipeline<NoForwarding>;
+extern template class Pipeline<EXBypassOnly>;
+
+#endif
@@ -0,0 +1,102 @@
+#include "PipelineDiagram.hpp"
+#include "PipelineTrace.hpp"
+#include "Simulation.hpp"
+#include <string>
+#include <vector>
+using namespace std;
+
+string stageName(int stage)
+{
+    switch (stage)
+    {
+    case 1:
+        return "IF";
+    case 2:
+        return "ID";
+    case 3:
+        return "EX";
+    case 4:
+        return "MEM";
+    case 5:
+        return "WB";
+    default:
+        return "-";
+    }
+}
+
+PipelineDiagram::PipelineDiagram(int rows, int numCycles, bool showSlots)
+    : numCycles(numCycles), showSlots(showSlots), runs(rows > 0 ? rows : 0)
+{
+}
+
+void PipelineDiagram::Record(int cycle, int row, int stage, int slot, int part)
+{
+    if (row < 0 || row >= (int)runs.size() || cycle < 0 || cycle >= numCycles)
+        return;
+    for (PipelineTrace *trace : traces)
+        trace->Record(cycle, row, stage, slot, part);
+    if (!store)
+        return;
+
+    vector<Run> &r = runs[row];
+    // The cell was already written this cycle: the later write wins.
+    if (!r.empty() && r.back().end > cycle)
+    {
+        if (r.back().stage == stage && r.back().slot == slot && r.back().part == part)
+            return;
+        if (r.back().end - r.back().start == 1)
+            r.pop_back();
+        else
+            r.back().end--;
+    }
+    if (!r.empty() && r.back().end == cycle && r.back().stage == stage && r.back().slot == slot && r.back().part == part)
+        r.back().end++;
+    else
+        r.push_back({cycle, cycle + 1, (uint8_t)stage, (uint8_t)slot, (uint8_t)part});
+}
+
+void PipelineDiagram::Write(ostream &out, const vector<string> &labels) const
+{
+    string line;
+    for (size_t i = 0; i < runs.size(); i++)
+    {
+        line = (i < labels.size()) ? labels[i] : "";
+        int cycle = 0;
+        for (const Run &run : runs[i])
+        {
+            for (; cycle < run.start; cycle++)
+                line += "; ";
+            // First cycle of a stage shows its name, the rest are stalls.
+            line += ';';
+            line += cellName(run);
+            for (cycle++; cycle < run.end; cycle++)
+                line += ";-";
+        }
+        line += '\n';
+        out << line;
+    }
+}
+
+void PipelineDiagram::WriteCsv(ostream &out, const vector<string> &labels, int firstCycle) const
+{
+    out << "pc,instruction,stage,start,end\n";
+    for (size_t i = 0; i < runs.size(); i++)
+    {
+        string label = CsvField((i < labels.size()) ? labels[i] : "");
+        for (const Run &run : runs[i])
+            out << i << ',' << label << ',' << cellName(run) << ',' << firstCycle + run.start << ',' << firstCycle + run.end << '\n';
+    }
+}
+
+string PipelineDiagram::cellName(const Run &run) const
+{
+    string name = stageName(run.stage);
+    if (run.part)
+        name += to_string(run.part);
+    if (showSlots)
+    {
+        name += '/';
+        name += to_string(run.slot);
+    }
+    return name;
+}
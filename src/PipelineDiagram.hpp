@@ -0,0 +1,63 @@
+#ifndef PIPELINE_DIAGRAM_HPP
+#define PIPELINE_DIAGRAM_HPP
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+class PipelineTrace;
+
+// Pipeline diagram kept as run-length stage events per instruction row.
+// Each row stores one Run per stage occupancy instead of one cell per cycle,
+// so memory is O(stage transitions) rather than instructions x cycles. It
+// is not bounded: every loop iteration appends runs to its rows, so a
+// loop-bound program still grows linearly with the cycle count. The rows
+// are only written after the run, since each spans every cycle.
+class PipelineDiagram
+{
+public:
+    // With showSlots, every cell also names the issue slot ("EX/1")
+    PipelineDiagram(int rows, int numCycles, bool showSlots = false);
+
+    // Mark `row` as being in `stage` (1..5 = IF..WB), in `slot` of a
+    // superscalar stage, during `cycle`; `part` numbers the sub-stages of a
+    // stage split by --depth ("EX2"), 0 if it is not split. Cycles must be
+    // recorded in non-decreasing order; a later record for the same row and
+    // cycle replaces the earlier one.
+    void Record(int cycle, int row, int stage, int slot = 0, int part = 0);
+
+    // Also pass every record within the diagram's rows and cycles to trace
+    void Attach(PipelineTrace *trace) { traces.push_back(trace); }
+    // Keep nothing and only pass records on to the traces (--trace-bin)
+    void TraceOnly() { store = false; }
+
+    // Write the ";IF;ID;-;EX" rows, one per instruction, prefixed by its label.
+    void Write(std::ostream &out, const std::vector<std::string> &labels) const;
+    // One "pc,instruction,stage,start,end" line per stay in a stage, with
+    // end exclusive and firstCycle added to both cycles
+    void WriteCsv(std::ostream &out, const std::vector<std::string> &labels, int firstCycle = 0) const;
+
+private:
+    struct Run
+    {
+        int start; // first cycle
+        int end;   // one past the last cycle
+        uint8_t stage;
+        uint8_t slot;
+        uint8_t part;
+    };
+
+    int numCycles;
+    bool showSlots;
+    bool store = true;
+    std::vector<std::vector<Run>> runs;
+    std::vector<PipelineTrace *> traces;
+
+    // The cell text of the first cycle of run ("EX2", "EX/1")
+    std::string cellName(const Run &run) const;
+};
+
+std::string stageName(int stage);
+
+#endif
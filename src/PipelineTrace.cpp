@@ -0,0 +1,30 @@
+#include "PipelineTrace.hpp"
+using namespace std;
+
+void PipelineTrace::Record(int cycle, int row, int stage, int slot, int part)
+{
+    if (cycle != current)
+    {
+        if (!cells.empty())
+            Cycle(current, cells);
+        cells.clear();
+        current = cycle;
+    }
+    cells.push_back({row, (uint8_t)stage, (uint8_t)slot, (uint8_t)part});
+}
+
+bool PipelineTrace::Shown(const vector<Cell> &cells, size_t i)
+{
+    for (size_t j = i + 1; j < cells.size(); j++)
+        if (cells[j].row == cells[i].row)
+            return false;
+    return true;
+}
+
+void PipelineTrace::Finish()
+{
+    if (!cells.empty())
+        Cycle(current, cells);
+    cells.clear();
+    Close();
+}
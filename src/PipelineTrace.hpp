@@ -0,0 +1,47 @@
+#ifndef PIPELINE_TRACE_HPP
+#define PIPELINE_TRACE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// A trace written while the simulation runs (--trace, --kanata), fed with
+// the same stage records as the diagram (PipelineDiagram::Attach). Records
+// arrive cycle by cycle; once a cycle is complete the writer gets all of
+// its cells in the order they were recorded. A row may appear more than
+// once when a short loop refetches an instruction that is still in
+// flight; the diagram keeps only the later record (see Shown()). Cycles in
+// which nothing was recorded are not passed on.
+class PipelineTrace
+{
+public:
+    struct Cell
+    {
+        int row;
+        uint8_t stage; // 1..5 = IF..WB
+        uint8_t slot;
+        uint8_t part;
+    };
+
+    virtual ~PipelineTrace() {}
+
+    // Same arguments as PipelineDiagram::Record, cycles in non-decreasing order
+    void Record(int cycle, int row, int stage, int slot, int part);
+    // Pass on the last cycle and close the trace; call once after the run
+    void Finish();
+
+protected:
+    // The cells of cycle, in record order
+    virtual void Cycle(int cycle, const std::vector<Cell> &cells) = 0;
+    // Whether cells[i] is what the diagram shows for its row: no later
+    // cell of the cycle names the same row
+    static bool Shown(const std::vector<Cell> &cells, size_t i);
+    // Nothing follows the last Cycle
+    virtual void Close() {}
+
+private:
+    int current = -1; // Cycle being collected
+    std::vector<Cell> cells;
+};
+
+#endif
@@ -0,0 +1,250 @@
+#include "Predecode.hpp"
+#include "Processor.hpp"
+#include <string>
+#include <cstdint>
+using namespace std;
+
+// Instruction formats, used to pick the register fields and immediate layout
+enum InstrFormat
+{
+    FMT_NONE = 0,
+    FMT_R,       // rs1, rs2, rd
+    FMT_I,       // rs1, rd, imm[11:0]
+    FMT_I_SHIFT, // rs1, rd, shamt in bits 24:20
+    FMT_S,       // rs1, rs2, imm[11:5|4:0]
+    FMT_B,       // rs1, rs2, imm[12|10:5|4:1|11]
+    FMT_U,       // rd, imm[31:12]
+    FMT_J        // rd, imm[20|10:1|11|19:12]
+};
+
+struct DecodeEntry
+{
+    uint8_t Class;
+    uint8_t Format;
+    uint8_t ALUOp;
+    uint8_t MemSize;
+    uint8_t BranchType;
+    bool MemSignExtend;
+};
+
+// The table is indexed by opcode[6:2], funct3 and a 2-bit funct7 selector:
+// 0 = 0000000, 1 = 0100000, 3 = 0000001 (M extension), 2 = anything else.
+static constexpr unsigned tableIndex(unsigned op5, unsigned funct3, unsigned f7sel)
+{
+    return (op5 << 5) | (funct3 << 2) | f7sel;
+}
+
+static constexpr unsigned funct7Select(uint32_t funct7)
+{
+    return funct7 == 0x00 ? 0 : funct7 == 0x20 ? 1 : funct7 == 0x01 ? 3 : 2;
+}
+
+static constexpr DecodeEntry entry(uint8_t cls, uint8_t fmt, uint8_t aluOp, uint8_t memSize = 0, bool signExtend = false, uint8_t branchType = 0)
+{
+    return DecodeEntry{cls, fmt, aluOp, memSize, branchType, signExtend};
+}
+
+static constexpr DecodeEntry makeEntry(unsigned op5, unsigned funct3, unsigned f7sel)
+{
+    const DecodeEntry unknown = entry(CLASS_UNKNOWN, FMT_NONE, 0);
+    switch (op5)
+    {
+    case 0x0C: // 0110011: R-type
+        if (f7sel == 0)
+        {
+            // ADD, SLL, SLT, SLTU, XOR, SRL, OR, AND
+            const uint8_t ops[8] = {2, 7, 10, 11, 6, 8, 5, 4};
+            return entry(CLASS_ALU, FMT_R, ops[funct3]);
+        }
+        if (f7sel == 1 && funct3 == 0)
+            return entry(CLASS_ALU, FMT_R, 3); // SUB
+        if (f7sel == 1 && funct3 == 5)
+            return entry(CLASS_ALU, FMT_R, 9); // SRA
+        if (f7sel == 3)
+        {
+            // MUL, MULH, MULHSU, MULHU, DIV, DIVU, REM, REMU
+            const uint8_t ops[8] = {12, 13, 15, 14, 16, 17, 18, 19};
+            return entry(CLASS_ALU, FMT_R, ops[funct3]);
+        }
+        return unknown;
+    case 0x04: // 0010011: I-type arithmetic
+        if (funct3 == 1)
+            return f7sel == 0 ? entry(CLASS_ALU, FMT_I_SHIFT, 7) : unknown; // SLLI
+        if (funct3 == 5)
+            return f7sel == 0   ? entry(CLASS_ALU, FMT_I_SHIFT, 8)          // SRLI
+                   : f7sel == 1 ? entry(CLASS_ALU, FMT_I_SHIFT, 9)          // SRAI
+                                : unknown;
+        {
+            // ADDI, -, SLTI, SLTIU, XORI, -, ORI, ANDI
+            const uint8_t ops[8] = {2, 0, 10, 11, 6, 0, 5, 4};
+            return entry(CLASS_ALU, FMT_I, ops[funct3]);
+        }
+    case 0x0D: // 0110111: LUI
+        return entry(CLASS_ALU, FMT_U, 20);
+    case 0x00: // 0000011: loads, address calculation uses addition
+    {
+        // LB, LH, LW, -, LBU, LHU
+        const uint8_t sizes[8] = {1, 2, 4, 0, 1, 2, 0, 0};
+        return entry(CLASS_LOAD, FMT_I, 2, sizes[funct3], funct3 < 3);
+    }
+    case 0x08: // 0100011: stores
+    {
+        // SB, SH, SW
+        const uint8_t sizes[8] = {1, 2, 4, 0, 0, 0, 0, 0};
+        return entry(CLASS_STORE, FMT_S, 2, sizes[funct3]);
+    }
+    case 0x18: // 1100011: branches
+    {
+        // BEQ, BNE, -, -, BLT, BGE, BLTU, BGEU
+        const int types[8] = {0, 1, -1, -1, 2, 3, 4, 5};
+        if (types[funct3] < 0)
+            return unknown;
+        // BEQ/BNE compare with SUB, BLT/BGE with SLT, BLTU/BGEU with SLTU
+        const uint8_t ops[6] = {3, 3, 10, 10, 11, 11};
+        return entry(CLASS_BRANCH, FMT_B, ops[types[funct3]], 0, false, types[funct3]);
+    }
+    case 0x1B: // 1101111: JAL
+        return entry(CLASS_JAL, FMT_J, 2);
+    case 0x19: // 1100111: JALR
+        return funct3 == 0 ? entry(CLASS_JALR, FMT_I, 2) : unknown;
+    default:
+        return unknown;
+    }
+}
+
+struct DecodeTable
+{
+    DecodeEntry entries[32 * 8 * 4];
+};
+
+static constexpr DecodeTable makeTable()
+{
+    DecodeTable table = {};
+    for (unsigned op5 = 0; op5 < 32; op5++)
+        for (unsigned funct3 = 0; funct3 < 8; funct3++)
+            for (unsigned f7sel = 0; f7sel < 4; f7sel++)
+                table.entries[tableIndex(op5, funct3, f7sel)] = makeEntry(op5, funct3, f7sel);
+    return table;
+}
+
+static constexpr DecodeTable decodeTable = makeTable();
+
+bool hexToWord(const string &hex, uint32_t &word)
+{
+    if (hex.size() != 8)
+        return false;
+    word = 0;
+    for (char ch : hex)
+    {
+        uint32_t val;
+        if (ch >= '0' && ch <= '9')
+            val = ch - '0';
+        else if (ch >= 'a' && ch <= 'f')
+            val = ch - 'a' + 10;
+        else if (ch >= 'A' && ch <= 'F')
+            val = ch - 'A' + 10;
+        else
+            return false;
+        word = (word << 4) | val;
+    }
+    return true;
+}
+
+DecodedInstr DecodeWord(uint32_t word)
+{
+    DecodedInstr d = {};
+    if ((word & 0x3) != 0x3)
+        return d;
+
+    const DecodeEntry &e = decodeTable.entries[tableIndex((word >> 2) & 0x1F, (word >> 12) & 0x7, funct7Select(word >> 25))];
+    if (e.Class == CLASS_UNKNOWN)
+        return d;
+
+    int rd = (word >> 7) & 0x1F;
+    int rs1 = (word >> 15) & 0x1F;
+    int rs2 = (word >> 20) & 0x1F;
+    int32_t sword = (int32_t)word;
+
+    d.Class = e.Class;
+    d.ALUOp = e.ALUOp;
+    d.MemSize = e.MemSize;
+    d.MemSignExtend = e.MemSignExtend;
+    d.BranchType = e.BranchType;
+    d.RR1 = -1;
+    d.RR2 = -1;
+    switch (e.Format)
+    {
+    case FMT_R:
+        d.RR1 = rs1;
+        d.RR2 = rs2;
+        d.WR = rd;
+        d.RegDst = true;
+        break;
+    case FMT_I:
+        d.RR1 = rs1;
+        d.WR = rd;
+        d.Imm = sword >> 20;
+        break;
+    case FMT_I_SHIFT:
+        d.RR1 = rs1;
+        d.WR = rd;
+        d.Imm = rs2; // shamt
+        break;
+    case FMT_S:
+        d.RR1 = rs1; // base register
+        d.RR2 = rs2; // source register
+        d.Imm = ((sword >> 25) << 5) | rd;
+        break;
+    case FMT_B:
+        d.RR1 = rs1;
+        d.RR2 = rs2;
+        d.Imm = ((sword >> 31) << 12) | (((word >> 7) & 0x1) << 11) | (((word >> 25) & 0x3F) << 5) | (((word >> 8) & 0xF) << 1);
+        break;
+    case FMT_U:
+        d.WR = rd;
+        d.Imm = (int32_t)(word & 0xFFFFF000);
+        break;
+    case FMT_J:
+        d.WR = rd;
+        d.Imm = ((sword >> 31) << 20) | (word & 0xFF000) | (((word >> 20) & 0x1) << 11) | (((word >> 21) & 0x3FF) << 1);
+        break;
+    }
+
+    d.RegWrite = (e.Class == CLASS_ALU || e.Class == CLASS_LOAD || e.Class == CLASS_JAL || e.Class == CLASS_JALR);
+    d.MemRead = (e.Class == CLASS_LOAD);
+    d.MemWrite = (e.Class == CLASS_STORE);
+    d.MemtoReg = (e.Class == CLASS_LOAD);
+    d.ALUSrc = (e.Format != FMT_R && e.Format != FMT_B);
+    return d;
+}
+
+DecodedInstr Predecode(const string &hex)
+{
+    uint32_t word;
+    if (!hexToWord(hex, word))
+        return DecodedInstr();
+    return DecodeWord(word);
+}
+
+// Load the control signals of a predecoded instruction into the ID latch
+void ApplyDecoded(IDStage &ID, const DecodedInstr &instr)
+{
+    ID.RR1 = instr.RR1;
+    ID.RR2 = instr.RR2;
+    ID.WR = instr.WR;
+    ID.Imm = instr.Imm;
+    ID.RegWrite = instr.RegWrite;
+    ID.RegDst = instr.RegDst;
+    ID.Branch = (instr.Class == CLASS_BRANCH);
+    ID.Jump = false;
+    ID.MemRead = instr.MemRead;
+    ID.MemWrite = instr.MemWrite;
+    ID.ALUSrc = instr.ALUSrc;
+    ID.ALUOp = instr.ALUOp;
+    ID.MemtoReg = instr.MemtoReg;
+    ID.MemSize = instr.MemSize;
+    ID.MemSignExtend = instr.MemSignExtend;
+    ID.BranchType = instr.BranchType;
+    ID.JumpAndLink = false;
+    ID.JumpReg = false;
+}
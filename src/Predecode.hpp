@@ -0,0 +1,50 @@
+#ifndef PREDECODE_HPP
+#define PREDECODE_HPP
+
+#include <cstdint>
+#include <string>
+
+struct IDStage;
+
+// Instruction classes produced by the predecoder
+enum InstrClass
+{
+    CLASS_UNKNOWN = 0, // Unsupported encoding; ID keeps its previous control signals
+    CLASS_ALU,         // R-type, I-type arithmetic and LUI
+    CLASS_LOAD,
+    CLASS_STORE,
+    CLASS_BRANCH,
+    CLASS_JAL,
+    CLASS_JALR
+};
+
+// Control signals of one instruction, decoded once when the program is loaded
+struct DecodedInstr
+{
+    uint8_t Class; // InstrClass
+    int8_t RR1;    // rs1, -1 if unused
+    int8_t RR2;    // rs2, -1 if unused
+    int8_t WR;     // rd
+    int32_t Imm;   // Sign-extended immediate
+
+    uint8_t ALUOp;      // Operation code for the ALU (see process_EX)
+    uint8_t MemSize;    // Size of memory access (1, 2, or 4 bytes)
+    uint8_t BranchType; // BEQ, BNE, BLT, BGE, BLTU, BGEU = 0..5
+
+    bool RegWrite;
+    bool RegDst;
+    bool MemRead;
+    bool MemWrite;
+    bool ALUSrc;
+    bool MemtoReg;
+    bool MemSignExtend;
+};
+
+// Parse an 8-digit hex instruction word; returns false on malformed input
+bool hexToWord(const std::string &hex, uint32_t &word);
+// Table-driven decode of a raw RV32 instruction word
+DecodedInstr DecodeWord(uint32_t word);
+DecodedInstr Predecode(const std::string &hex);
+void ApplyDecoded(IDStage &ID, const DecodedInstr &instr);
+
+#endif
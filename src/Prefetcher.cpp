@@ -0,0 +1,101 @@
+#include "Prefetcher.hpp"
+#include <vector>
+using namespace std;
+
+void NextLinePrefetcher::Observe(int pc, uint32_t addr, bool trigger, vector<uint32_t> &out)
+{
+    if (!trigger)
+        return;
+    for (int i = 1; i <= degree; i++)
+        out.push_back(addr + i * lineSize);
+}
+
+StridePrefetcher::StridePrefetcher(int entries, int degree)
+    : table(entries, Entry{-1, 0, 0, 0}), mask(entries - 1), degree(degree)
+{
+}
+
+void StridePrefetcher::Observe(int pc, uint32_t addr, bool trigger, vector<uint32_t> &out)
+{
+    Entry &entry = table[pc & mask];
+    if (entry.pc != pc)
+    {
+        entry = {pc, addr, 0, 0};
+        return;
+    }
+    int32_t stride = (int32_t)(addr - entry.lastAddr);
+    if (stride != 0 && stride == entry.stride)
+    {
+        if (entry.confidence < 3)
+            entry.confidence++;
+    }
+    else
+    {
+        entry.stride = stride;
+        entry.confidence = 0;
+    }
+    entry.lastAddr = addr;
+    if (entry.confidence >= 1)
+        for (int i = 1; i <= degree; i++)
+            out.push_back(addr + i * entry.stride);
+}
+
+StreamPrefetcher::StreamPrefetcher(int streams, int lineSize, int degree)
+    : streams(streams, Stream{false, 0, 0, 0}), lineBits(0), degree(degree), clock(0)
+{
+    while ((1 << lineBits) < lineSize)
+        lineBits++;
+}
+
+void StreamPrefetcher::Observe(int pc, uint32_t addr, bool trigger, vector<uint32_t> &out)
+{
+    if (!trigger)
+        return;
+    uint32_t line = addr >> lineBits;
+    clock++;
+
+    // A trigger within `degree` lines of a stream (in its direction, if
+    // known) continues it; otherwise the least recently used stream restarts
+    Stream *stream = nullptr;
+    Stream *oldest = &streams[0];
+    for (Stream &s : streams)
+    {
+        int32_t distance = (int32_t)(line - s.lastLine);
+        if (s.valid && distance != 0 && distance >= -degree && distance <= degree &&
+            (s.direction == 0 || (distance > 0) == (s.direction > 0)))
+        {
+            stream = &s;
+            break;
+        }
+        if (!s.valid || s.lastUse < oldest->lastUse)
+            oldest = &s;
+    }
+    if (!stream)
+    {
+        *oldest = {true, line, 0, clock};
+        return;
+    }
+    stream->direction = ((int32_t)(line - stream->lastLine) > 0) ? 1 : -1;
+    stream->lastLine = line;
+    stream->lastUse = clock;
+    for (int i = 1; i <= degree; i++)
+        out.push_back((line + i * stream->direction) << lineBits);
+}
+
+bool ValidPrefetchConfig(const PrefetchConfig &config)
+{
+    if (config.kind != "none" && config.kind != "nextline" && config.kind != "stride" && config.kind != "stream")
+        return false;
+    return config.degree > 0 && config.entries > 0 && (config.kind != "stride" || (config.entries & (config.entries - 1)) == 0);
+}
+
+unique_ptr<Prefetcher> MakePrefetcher(const PrefetchConfig &config, int lineSize)
+{
+    if (config.kind == "nextline")
+        return unique_ptr<Prefetcher>(new NextLinePrefetcher(lineSize, config.degree));
+    if (config.kind == "stride")
+        return unique_ptr<Prefetcher>(new StridePrefetcher(config.entries, config.degree));
+    if (config.kind == "stream")
+        return unique_ptr<Prefetcher>(new StreamPrefetcher(config.entries, lineSize, config.degree));
+    return nullptr;
+}
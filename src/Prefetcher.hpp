@@ -0,0 +1,97 @@
+#ifndef PREFETCHER_HPP
+#define PREFETCHER_HPP
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Data prefetcher attached to a cache. The cache reports every demand
+// access to it and fills the lines it asks for; usefulness and timeliness
+// are counted by the cache (Cache::Report).
+class Prefetcher
+{
+public:
+    virtual ~Prefetcher() {}
+
+    // Demand access to addr by the instruction at pc (an instruction index).
+    // trigger is true for a miss or the first use of a prefetched line.
+    // Appends the byte addresses to prefetch to out.
+    virtual void Observe(int pc, uint32_t addr, bool trigger, std::vector<uint32_t> &out) = 0;
+
+    virtual const char *Name() const = 0;
+};
+
+// On every trigger, fetch the next `degree` lines
+class NextLinePrefetcher : public Prefetcher
+{
+public:
+    NextLinePrefetcher(int lineSize, int degree) : lineSize(lineSize), degree(degree) {}
+    void Observe(int pc, uint32_t addr, bool trigger, std::vector<uint32_t> &out) override;
+    const char *Name() const override { return "nextline"; }
+
+private:
+    int lineSize;
+    int degree;
+};
+
+// Table indexed by PC holding each load/store's last address and stride;
+// once the same stride is seen twice in a row, fetch `degree` strides ahead
+class StridePrefetcher : public Prefetcher
+{
+public:
+    StridePrefetcher(int entries, int degree);
+    void Observe(int pc, uint32_t addr, bool trigger, std::vector<uint32_t> &out) override;
+    const char *Name() const override { return "stride"; }
+
+private:
+    struct Entry
+    {
+        int pc; // -1 = empty
+        uint32_t lastAddr;
+        int32_t stride;
+        int confidence; // 0..3
+    };
+    std::vector<Entry> table;
+    int mask;
+    int degree;
+};
+
+// Stream buffers: each tracks one ascending or descending run of missing
+// lines and, once its direction is known, keeps `degree` lines ahead of it
+class StreamPrefetcher : public Prefetcher
+{
+public:
+    StreamPrefetcher(int streams, int lineSize, int degree);
+    void Observe(int pc, uint32_t addr, bool trigger, std::vector<uint32_t> &out) override;
+    const char *Name() const override { return "stream"; }
+
+private:
+    struct Stream
+    {
+        bool valid;
+        uint32_t lastLine;
+        int direction; // +1, -1 or 0 while still unknown
+        long lastUse;
+    };
+    std::vector<Stream> streams;
+    int lineBits;
+    int degree;
+    long clock;
+};
+
+// Prefetcher selection from the command line
+struct PrefetchConfig
+{
+    std::string kind = "none"; // none, nextline, stride or stream
+    int degree = 2;            // Lines (or strides) fetched ahead
+    int entries = 16;          // Stride table entries (power of two) or stream buffers
+};
+
+// nullptr for "none"
+std::unique_ptr<Prefetcher> MakePrefetcher(const PrefetchConfig &config, int lineSize);
+
+// True if config names a known prefetcher with valid sizes
+bool ValidPrefetchConfig(const PrefetchConfig &config);
+
+#endif
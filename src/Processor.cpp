@@ -0,0 +1,381 @@
+#include "Processor.hpp"
+#include "Execute.hpp"
+#include <ostream>
+#include <vector>
+using namespace std;
+
+Processor::Processor(const vector<DecodedInstr> &program)
+    : program(program)
+{
+    Reset();
+}
+
+void Processor::Reset()
+{
+    IF = {0, false, -1, -1, -1, false, -1, false};
+    ID = {
+        .RR1 = 0,
+        .RR2 = 0,
+        .WR = 0,
+        .RD1 = 0,
+        .RD2 = 0,
+        .Imm = 0,
+        .RegWrite = false,
+        .RegDst = false,
+        .Branch = false,
+        .Jump = false,
+        .MemRead = false,
+        .MemWrite = false,
+        .ALUSrc = false,
+        .ALUOp = 0,
+        .MemtoReg = false,
+        .MemSize = 0,
+        .MemSignExtend = false,
+        .BranchType = 0,
+        .JumpAndLink = false,
+        .JumpReg = false,
+        .stall = false,
+        .InStr = -1,
+        .DM_stall_prev = 0,
+        .ALU_stall_prev = false,
+        .DM_stall_prev2 = false};
+    EX = {
+        .ALU_res = 0,
+        .Zero = false,
+        .WriteData = 0,
+        .WriteDataReg = 0,
+        .WriteReg = 0,
+        .Branch = false,
+        .Jump = false,
+        .MemRead = false,
+        .MemWrite = false,
+        .MemtoReg = false,
+        .RegWrite = false,
+        .MemSize = 0,
+        .MemSignExtend = false,
+        .InStr = -1,
+        .stall = false};
+    DM = {
+        .Address = 0,
+        .Write_data = 0,
+        .Read_data = 0,
+        .MemRead = false,
+        .MemWrite = false,
+        .MemtoReg = false,
+        .RegWrite = false,
+        .ALU_res = 0,
+        .WriteReg = 0,
+        .MemSize = 0,
+        .MemSignExtend = false,
+        .InStr = -1,
+        .stall = false};
+    WB = {
+        .MemtoReg = false,
+        .RegWrite = false,
+        .Read_data = 0,
+        .ALU_res = 0,
+        .WriteReg = 0,
+        .InStr = -1,
+        .stall = false};
+
+    now = 0;
+    for (int i = 0; i < 32; i++)
+        regReady[i] = 0;
+    divFreeAt = 0;
+    memStall = 0;
+    fetchWait = 0;
+    fetchFilled = false;
+    slotReason = STALL_EMPTY;
+    slotInstr = -1;
+    fetchBubble = STALL_EMPTY;
+    fetchBubbleInstr = -1;
+
+    // Initialize register file to 0.
+    for (int i = 0; i < 32; i++)
+    {
+        RegFile[i].value = 0;
+    }
+}
+
+void Processor::ConfigurePredictors(const PredictorConfig &config)
+{
+    predictor = MakePredictor(config);
+    btb.reset(config.btbEntries ? new BranchTargetBuffer(config.btbEntries) : nullptr);
+    ras.reset(config.rasDepth ? new ReturnAddressStack(config.rasDepth) : nullptr);
+}
+
+void Processor::ReportPredictors(ostream &out) const
+{
+    if (predictor)
+        predictor->Report(out);
+    if (btb)
+        btb->Report(out);
+    if (ras)
+        ras->Report(out);
+}
+
+void Processor::ConfigureCaches(const MemoryConfig &config)
+{
+    l2.reset(config.l2.size ? new Cache("L2", config.l2, nullptr, config.memLatency) : nullptr);
+    icache.reset(config.l1i.size ? new Cache("L1I", config.l1i, l2.get(), config.memLatency) : nullptr);
+    dcache.reset(config.l1d.size ? new Cache("L1D", config.l1d, l2.get(), config.memLatency) : nullptr);
+    if (dcache)
+        dcache->AttachPrefetcher(MakePrefetcher(config.prefetch, config.l1d.lineSize));
+}
+
+void Processor::ReportCaches(ostream &out) const
+{
+    if (icache)
+        icache->Report(out);
+    if (dcache)
+        dcache->Report(out);
+    if (l2)
+        l2->Report(out);
+}
+
+void Processor::process_IF()
+{
+    if (IF.stall)
+    {
+        // cout << "IF stage stalled; PC remains at " << IF.PC << endl;
+        IF.stall = false;
+        return;
+    }
+    if (fetchWait > 0 && --fetchWait > 0)
+    {
+        IF.InStr = -1;
+        fetchBubble = STALL_ICACHE;
+        fetchBubbleInstr = IF.PC;
+        return;
+    }
+    if (IF.PC >= 0 && IF.PC < (int)program.size())
+        IF.InStr = IF.PC;
+    else
+    {
+        IF.InStr = -1;
+        fetchBubble = STALL_EMPTY;
+        fetchBubbleInstr = -1;
+    }
+    if (IF.branch == 2)
+    {
+        IF.InStr = IF.PC;
+        IF.branch = -1;
+    }
+    if (IF.branch == 3)
+    {
+        IF.InStr = IF.PC;
+        IF.branch = -1;
+        // cout << IF.PC << endl;
+    }
+    if (IF.branch == 0)
+    {   
+        IF.PC-=1;
+        IF.branch = 2;
+        IF.InStr = -1;
+        //cout << "bye";
+    }
+    if (IF.branch == 1)
+    {
+        IF.branch = 3;
+        IF.InStr = -1;
+        IF.PC = IF.branchPC-1;
+        IF.branchPC = -1;
+    }
+    if (IF.branch == 2 || IF.branch == 3)
+    {
+        // Squashed behind the branch or jump ID has just resolved
+        fetchBubble = STALL_CONTROL;
+        fetchBubbleInstr = ID.InStr;
+    }
+
+    // An I-cache miss turns this fetch into bubbles; the same PC is fetched
+    // again once the line has arrived
+    if (icache && IF.InStr != -1)
+    {
+        if (fetchFilled)
+            fetchFilled = false;
+        else
+        {
+            int extra = icache->Access(CODE_BASE + 4 * (uint32_t)IF.InStr, false) - 1;
+            if (extra > 0)
+            {
+                fetchWait = extra;
+                fetchFilled = true;
+                fetchBubble = STALL_ICACHE;
+                fetchBubbleInstr = IF.InStr;
+                IF.InStr = -1;
+                predictNextFetch();
+                return;
+            }
+        }
+    }
+
+    IF.PC++;
+    predictNextFetch();
+}
+
+// Calls write the link register (x1 or x5); returns jump through it to x0
+static bool isLink(int reg)
+{
+    return reg == 1 || reg == 5;
+}
+
+// Redirect fetch after the instruction just fetched into IF.InStr:
+// conditional branches follow the direction predictor, JAL/JALR the return
+// address stack or the BTB. ID resolves before IF fetches and a stall in ID
+// holds IF, so fetch never runs ahead of an unresolved jump and the stack
+// needs no repair after a misprediction.
+void Processor::predictNextFetch()
+{
+    IF.predicted = false;
+    IF.predictedTarget = -1;
+    IF.fromRAS = false;
+    if (IF.InStr < 0 || IF.InStr >= (int)program.size())
+        return;
+
+    const DecodedInstr &instr = program[IF.InStr];
+    if (instr.Class == CLASS_BRANCH)
+    {
+        if (predictor)
+        {
+            int target = IF.InStr + instr.Imm / 4;
+            IF.predicted = predictor->Predict(IF.InStr, target);
+            if (IF.predicted)
+                IF.PC = target;
+        }
+    }
+    else if (instr.Class == CLASS_JAL || instr.Class == CLASS_JALR)
+    {
+        int target, link;
+        if (ras && instr.Class == CLASS_JALR && instr.WR == 0 && isLink(instr.RR1))
+        {
+            // Same target computation as the JALR in ID, on the predicted rs1
+            if (ras->Pop(link))
+            {
+                IF.predictedTarget = (link + instr.Imm) / 4;
+                IF.fromRAS = true;
+            }
+        }
+        else if (btb && btb->Lookup(IF.InStr, target))
+            IF.predictedTarget = target;
+
+        if (ras && isLink(instr.WR))
+            ras->Push(IF.InStr + 1);
+        if (IF.predictedTarget != -1)
+            IF.PC = IF.predictedTarget;
+    }
+}
+
+// Whether instr, decoded in ID this cycle, cannot enter EX next cycle:
+// STALL_MULDIV if a source register is still being computed by the
+// multiplier or divider, STALL_STRUCTURAL if instr is a division and the
+// divider is busy, STALL_NONE otherwise
+StallReason Processor::mulDivHazard(const DecodedInstr &instr) const
+{
+    long enterEX = now + 1;
+    if (instr.RR1 > 0 && regReady[instr.RR1] > enterEX)
+        return STALL_MULDIV;
+    if (instr.RR2 > 0 && regReady[instr.RR2] > enterEX)
+        return STALL_MULDIV;
+    if (instr.Class == CLASS_ALU && IsDivide(instr.ALUOp) && divFreeAt > enterEX)
+        return STALL_STRUCTURAL;
+    return STALL_NONE;
+}
+
+// Book the destination of the instruction entering EX this cycle. The
+// result is computed at once, and the instruction moves on to MEM and WB
+// as usual; only its consumers are held back.
+void Processor::issueMulDiv(int ALUOp, int WR, bool RegWrite)
+{
+    int latency = 1;
+    if (IsMultiply(ALUOp))
+        latency = muldiv.mulLatency;
+    else if (IsDivide(ALUOp))
+    {
+        latency = muldiv.divLatency;
+        divFreeAt = now + latency;
+    }
+    if (RegWrite)
+        regReady[WR] = now + latency;
+}
+
+void Processor::process_MEM()
+{
+    if (EX.InStr == -1)
+    {
+        DM.InStr = -1;
+        // Clear control signals to avoid persistent hazard.
+        DM.MemRead = false;
+        DM.MemWrite = false;
+        DM.RegWrite = false;
+        DM.MemtoReg = false;
+        DM.Address = 0;
+
+        return;
+    }
+
+    // Normal propagation when there is a valid instruction.
+    DM.InStr = EX.InStr;
+    DM.ALU_res = EX.ALU_res;
+    DM.Write_data = EX.WriteData;
+    DM.WriteReg = EX.WriteReg;
+    DM.MemRead = EX.MemRead;
+    DM.MemWrite = EX.MemWrite;
+    DM.MemtoReg = EX.MemtoReg;
+    DM.RegWrite = EX.RegWrite;
+    DM.Address = EX.ALU_res;
+
+    // Additional memory size and sign extend information
+    DM.MemSize = EX.MemSize;
+    DM.MemSignExtend = EX.MemSignExtend;
+
+    if (DM.MemRead)
+    {
+        // Load operations with different memory sizes and sign extension
+        DM.Read_data = LoadMem(MEM, DM.Address, DM.MemSize, DM.MemSignExtend);
+    }
+    else if (DM.MemWrite)
+    {
+        // Forward the store data from WB when it writes the source register
+        int data = DM.Write_data;
+        if (WB.RegWrite && WB.WriteReg == EX.WriteDataReg)
+            data = WB.MemtoReg ? WB.Read_data : WB.ALU_res;
+        StoreMem(MEM, DM.Address, DM.MemSize, data);
+    }
+
+    // A D-cache miss keeps the instruction in MEM (and everything behind it
+    // in place) for the extra cycles
+    if (dcache && (DM.MemRead || DM.MemWrite))
+        memStall = dcache->Access(DM.Address, DM.MemWrite, now, DM.InStr) - 1;
+}
+
+void Processor::process_WB()
+{
+    if (DM.InStr == -1)
+    {
+        bubbleWB();
+        return;
+    }
+    WB.InStr = DM.InStr;
+    WB.Read_data = DM.Read_data;
+    WB.MemtoReg = DM.MemtoReg;
+    WB.RegWrite = DM.RegWrite;
+    WB.ALU_res = DM.ALU_res;
+    WB.WriteReg = DM.WriteReg;
+
+    if (WB.RegWrite)
+    {
+        RegFile[WB.WriteReg].value = (WB.MemtoReg ? WB.Read_data : WB.ALU_res);
+        //cout << WB.WriteReg << " " << RegFile[WB.WriteReg].value << endl;
+    }
+}
+
+void Processor::bubbleWB()
+{
+    WB.InStr = -1;
+    WB.RegWrite = false;
+    WB.MemtoReg = false;
+    WB.ALU_res = 0;
+    WB.Read_data = 0;
+    WB.WriteReg = 0;
+}
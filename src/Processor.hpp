@@ -1,14 +1,22 @@
 #ifndef PROCESSOR_HPP
 #define PROCESSOR_HPP
 #include <cstdint>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <vector>
+#include "Memory.hpp"
+#include "BranchPredictor.hpp"
+#include "TargetPredictor.hpp"
+#include "Cache.hpp"
+#include "Predecode.hpp"
+#include "CpiStack.hpp"
 
 typedef struct
 {
     int value;
 } Register;
 
-extern Register RegFile[32];
-
 struct IFStage
 {
     int PC;
@@ -16,6 +24,9 @@ struct IFStage
     int InStr;
     int branch;
     int branchPC;
+    bool predicted;      // The fetched branch was predicted taken (fetch follows its target)
+    int predictedTarget; // Target fetch jumped to for the fetched JAL/JALR, -1 if none
+    bool fromRAS;        // predictedTarget came from the return address stack
 };
 
 struct IDStage
@@ -110,10 +121,108 @@ struct WBStage
     bool stall;
 };
 
-extern IFStage IF;
-extern IDStage ID;
-extern EXStage EX;
-extern MEMStage DM;
-extern WBStage WB;
+// Latencies of the M-extension units, in cycles spent in EX (1 = like any
+// other ALU operation)
+struct MulDivConfig
+{
+    int mulLatency = 3;  // Pipelined: a new multiply can start every cycle
+    int divLatency = 16; // Not pipelined: a division waits for the previous one
+};
+
+// One simulated core: the pipeline latches, register file and memory.
+// Objects are independent of each other, so a process can run any number
+// of simulations at once (e.g. one per thread). The stages that do not
+// depend on the hazard policy live here; Pipeline<Policy> (Pipeline.hpp)
+// adds ID and EX.
+class Processor
+{
+public:
+    IFStage IF;
+    IDStage ID;
+    EXStage EX;
+    MEMStage DM;
+    WBStage WB;
+
+    Register RegFile[32];
+    PagedMemory MEM;
+
+    // Predecoded program; must outlive the processor
+    const std::vector<DecodedInstr> &program;
+
+    // Conditional branch predictor used by IF; null means every branch
+    // stalls fetch for a cycle until ID resolves it
+    std::unique_ptr<BranchPredictor> predictor;
+    // JAL/JALR target prediction at fetch; null means every jump stalls
+    // fetch for a cycle until ID computes its target
+    std::unique_ptr<BranchTargetBuffer> btb;
+    std::unique_ptr<ReturnAddressStack> ras;
+    // Caches in front of fetch and data memory; a null level is ideal,
+    // single-cycle memory. l2 sits behind both L1s.
+    std::unique_ptr<Cache> icache;
+    std::unique_ptr<Cache> dcache;
+    std::unique_ptr<Cache> l2;
+    MulDivConfig muldiv;
+
+    // Instructions are not in MEM; they are fetched from their own region of
+    // the address space so they do not alias data lines in the unified L2
+    static const uint32_t CODE_BASE = 0x80000000u;
+
+    explicit Processor(const std::vector<DecodedInstr> &program);
+
+    // Empty the pipeline and zero the register file; memory is kept
+    void Reset();
+
+    // Create the direction predictor, BTB and RAS selected by config
+    void ConfigurePredictors(const PredictorConfig &config);
+    // Print the statistics of every predictor in use
+    void ReportPredictors(std::ostream &out) const;
+
+    // Create the caches selected by config
+    void ConfigureCaches(const MemoryConfig &config);
+    // Print the counters of every cache level in use
+    void ReportCaches(std::ostream &out) const;
+
+    // The coming cycle is spent waiting on a data cache miss (every stage holds)
+    bool MemoryStalled() const { return memStall > 0; }
+    // Cycles clocked since Reset
+    long Cycles() const { return now; }
+    // Why ID passed no instruction to EX in the last cycle (STALL_NONE if
+    // it did), and the instruction the cycle is charged to (-1 if none)
+    StallReason SlotReason() const { return slotReason; }
+    int SlotInstr() const { return slotInstr; }
+
+    // Write or read back everything the 5-stage pipeline needs to resume:
+    // latches, RegFile, MEM and the timing state of the hazard checks
+    // (Checkpoint.cpp). Predictor and cache contents are not included.
+    void SaveState(std::ostream &out) const;
+    bool RestoreState(std::istream &in);
+
+protected:
+    long now;         // Cycles clocked since Reset
+    long regReady[32]; // First cycle a consumer of the register may enter EX
+    long divFreeAt;    // First cycle the divider can accept a new division
+    int memStall;     // Cycles left before the instruction in MEM completes
+    int fetchWait;    // Cycles left before the missing fetch arrives
+    bool fetchFilled; // The line of the waiting fetch is now in the I-cache
+    StallReason slotReason;  // See SlotReason()
+    int slotInstr;
+    StallReason fetchBubble; // Why IF holds no instruction
+    int fetchBubbleInstr;    // ... and the instruction charged for it
+
+    // ID passes a bubble to EX this cycle because of instr
+    void bubble(StallReason reason, int instr)
+    {
+        slotReason = reason;
+        slotInstr = instr;
+    }
+
+    void process_IF();
+    void predictNextFetch();
+    StallReason mulDivHazard(const DecodedInstr &instr) const;
+    void issueMulDiv(int ALUOp, int WR, bool RegWrite);
+    void process_MEM();
+    void process_WB();
+    void bubbleWB();
+};
 
-#endif
\ No newline at end of file
+#endif
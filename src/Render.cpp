@@ -0,0 +1,138 @@
+// Offline renderer for the binary traces written with --trace-bin: the
+// diagram of the whole run, or of a window of cycles, in the simulator's
+// text format, as CSV, as Chrome trace-event JSON or as a Kanata log.
+//
+// Usage: ./render <trace.bin> <output> [--format F] [--from A] [--to B]
+//   Without --format the output's extension picks it: .csv, .json,
+//   .kanata, anything else text. The text of the whole run is the
+//   simulator's *_out.txt; a window [A, B) starts its columns at cycle A.
+//   CSV, JSON and Kanata keep the run's cycle numbers.
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <cstdlib>
+#include <memory>
+#include "BinaryTrace.hpp"
+#include "ChromeTrace.hpp"
+#include "KanataTrace.hpp"
+#include "PipelineDiagram.hpp"
+#include "Simulation.hpp"
+
+using namespace std;
+
+static void printUsage(const char *prog)
+{
+    cerr << "Usage: " << prog << " <trace.bin> <output> [options]" << endl;
+    cerr << "  --format F  text (the *_out.txt diagram), csv, json (Chrome trace events) or kanata (default: from the output's extension)" << endl;
+    cerr << "  --from A    first cycle to render (default 0)" << endl;
+    cerr << "  --to B      render the cycles before B (default: all)" << endl;
+}
+
+static bool endsWith(const string &text, const string &suffix)
+{
+    return text.size() >= suffix.size() && text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 3)
+    {
+        printUsage(argv[0]);
+        return 1;
+    }
+    string tracePath = argv[1], outPath = argv[2];
+    string format = endsWith(outPath, ".csv") ? "csv" : endsWith(outPath, ".json") ? "json" : endsWith(outPath, ".kanata") ? "kanata" : "text";
+    long from = 0, to = -1;
+    for (int i = 3; i < argc; i++)
+    {
+        string arg = argv[i];
+        if (arg == "--format" && i + 1 < argc)
+            format = argv[++i];
+        else if (arg == "--from" && i + 1 < argc)
+            from = atol(argv[++i]);
+        else if (arg == "--to" && i + 1 < argc)
+            to = atol(argv[++i]);
+        else
+        {
+            cerr << "Error: unknown option " << arg << endl;
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (format != "text" && format != "csv" && format != "json" && format != "kanata")
+    {
+        cerr << "Error: unknown format " << format << endl;
+        return 1;
+    }
+
+    ifstream in(tracePath, ios::binary);
+    if (!in)
+    {
+        cerr << "Error: Unable to open input file " << tracePath << endl;
+        return 1;
+    }
+    BinaryTraceReader reader(in);
+    BinaryTraceHeader header;
+    if (!reader.ReadHeader(header))
+    {
+        cerr << "Error: " << tracePath << " is not a binary pipeline trace" << endl;
+        return 1;
+    }
+    if (to < 0 || to > header.numCycles)
+        to = header.numCycles;
+    if (from < 0 || from > to)
+    {
+        cerr << "Error: invalid cycle window [" << from << ", " << to << ")" << endl;
+        return 1;
+    }
+    if ((format == "json" || format == "kanata") && !header.oneInSlot)
+    {
+        cerr << "Error: " << format << " needs one instruction per stage and slot; this trace is of the out-of-order core" << endl;
+        return 1;
+    }
+
+    bool ok;
+    if (format == "text" || format == "csv")
+    {
+        PipelineDiagram diagram(header.labels.size(), to - from, header.showSlots);
+        ok = reader.Replay(from, to, [&](int cycle, int row, int stage, int slot, int part) {
+            diagram.Record(cycle - from, row, stage, slot, part);
+        });
+        if (ok && format == "text")
+            return WriteDiagramFile(outPath, diagram, header.labels) ? 0 : 1;
+        if (ok)
+        {
+            ofstream out(outPath);
+            if (!out)
+            {
+                cerr << "Error: Unable to open output file " << outPath << endl;
+                return 1;
+            }
+            diagram.WriteCsv(out, header.labels, from);
+        }
+    }
+    else
+    {
+        ofstream out(outPath);
+        if (!out)
+        {
+            cerr << "Error: Unable to open output file " << outPath << endl;
+            return 1;
+        }
+        unique_ptr<PipelineTrace> trace;
+        if (format == "json")
+            trace.reset(new ChromeTrace(out, header.labels, header.title, header.showSlots));
+        else
+            trace.reset(new KanataTrace(out, header.labels));
+        ok = reader.Replay(from, to, [&](int cycle, int row, int stage, int slot, int part) {
+            trace->Record(cycle, row, stage, slot, part);
+        });
+        trace->Finish();
+    }
+    if (!ok)
+    {
+        cerr << "Error: " << tracePath << " is truncated or corrupt" << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,263 @@
+#include "Sampling.hpp"
+#include "Functional.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+using namespace std;
+
+static bool isControl(const DecodedInstr &instr)
+{
+    return instr.Class == CLASS_BRANCH || instr.Class == CLASS_JAL || instr.Class == CLASS_JALR;
+}
+
+// Basic block of every instruction. A block starts at instruction 0, at
+// every branch or JAL target and after every branch or jump; blockEnd is
+// one past its last instruction.
+static int basicBlocks(const vector<DecodedInstr> &program, vector<int> &blockOf, vector<int> &blockEnd)
+{
+    int size = program.size();
+    vector<bool> leader(size + 1, false);
+    leader[0] = true;
+    leader[size] = true;
+    for (int pc = 0; pc < size; pc++)
+    {
+        const DecodedInstr &instr = program[pc];
+        if (!isControl(instr))
+            continue;
+        leader[pc + 1] = true;
+        int target = pc + instr.Imm / 4;
+        if (instr.Class != CLASS_JALR && target >= 0 && target < size)
+            leader[target] = true;
+    }
+    blockOf.assign(size, 0);
+    blockEnd.assign(size, size);
+    int blocks = 0;
+    for (int pc = 0; pc < size; pc++)
+    {
+        if (leader[pc] && pc > 0)
+            blocks++;
+        blockOf[pc] = blocks;
+    }
+    for (int pc = size - 1; pc >= 0; pc--)
+        blockEnd[pc] = leader[pc + 1] ? pc + 1 : blockEnd[pc + 1];
+    return size ? blocks + 1 : 0;
+}
+
+vector<SampleInterval> ProfileIntervals(Processor &cpu, long interval, long maxInstrs)
+{
+    vector<int> blockOf, blockEnd;
+    int blocks = basicBlocks(cpu.program, blockOf, blockEnd);
+    int size = cpu.program.size();
+
+    vector<SampleInterval> intervals;
+    vector<long> counts(blocks, 0);
+    long executed = 0, inInterval = 0;
+    auto close = [&]() {
+        SampleInterval done = {executed - inInterval, inInterval, vector<double>(blocks), -1};
+        for (int b = 0; b < blocks; b++)
+            done.bbv[b] = (double)counts[b] / inInterval;
+        intervals.push_back(done);
+        fill(counts.begin(), counts.end(), 0);
+        inInterval = 0;
+    };
+
+    // Straight-line code runs a block at a time: a block only branches
+    // away at its last instruction
+    int pc = 0;
+    while (executed < maxInstrs && pc >= 0 && pc < size)
+    {
+        long run = min({(long)(blockEnd[pc] - pc), interval - inInterval, maxInstrs - executed});
+        int block = blockOf[pc];
+        long done = RunFunctional(cpu, pc, run);
+        counts[block] += done;
+        executed += done;
+        inInterval += done;
+        if (inInterval == interval)
+            close();
+        if (done < run)
+            break;
+    }
+    if (inInterval > 0)
+        close();
+    return intervals;
+}
+
+static double distance2(const vector<double> &a, const vector<double> &b)
+{
+    double sum = 0;
+    for (size_t i = 0; i < a.size(); i++)
+        sum += (a[i] - b[i]) * (a[i] - b[i]);
+    return sum;
+}
+
+int ClusterIntervals(vector<SampleInterval> &intervals, int clusters)
+{
+    int n = intervals.size();
+    int k = min(clusters, n);
+    if (k == 0)
+        return 0;
+
+    // k-means++ seeding: each further centre is drawn with probability
+    // proportional to its squared distance from the nearest chosen one
+    mt19937 random(1);
+    vector<vector<double>> centres = {intervals[uniform_int_distribution<int>(0, n - 1)(random)].bbv};
+    vector<double> nearest(n, numeric_limits<double>::max());
+    while ((int)centres.size() < k)
+    {
+        for (int i = 0; i < n; i++)
+            nearest[i] = min(nearest[i], distance2(intervals[i].bbv, centres.back()));
+        double total = 0;
+        for (double d : nearest)
+            total += d;
+        if (total == 0)
+            break; // Fewer distinct vectors than clusters
+        double pick = uniform_real_distribution<double>(0, total)(random);
+        int chosen = 0;
+        for (; chosen < n - 1 && pick >= nearest[chosen]; chosen++)
+            pick -= nearest[chosen];
+        centres.push_back(intervals[chosen].bbv);
+    }
+    k = centres.size();
+
+    for (int iteration = 0; iteration < 100; iteration++)
+    {
+        bool moved = false;
+        for (SampleInterval &interval : intervals)
+        {
+            int best = 0;
+            for (int c = 1; c < k; c++)
+                if (distance2(interval.bbv, centres[c]) < distance2(interval.bbv, centres[best]))
+                    best = c;
+            moved |= (best != interval.cluster);
+            interval.cluster = best;
+        }
+        if (!moved)
+            break;
+        for (int c = 0; c < k; c++)
+        {
+            vector<double> sum(centres[c].size(), 0.0);
+            int members = 0;
+            for (const SampleInterval &interval : intervals)
+            {
+                if (interval.cluster != c)
+                    continue;
+                for (size_t b = 0; b < sum.size(); b++)
+                    sum[b] += interval.bbv[b];
+                members++;
+            }
+            if (members == 0)
+                continue; // Keep an emptied centre where it was
+            for (double &value : sum)
+                value /= members;
+            centres[c] = sum;
+        }
+    }
+    return k;
+}
+
+vector<int> PickSamples(const vector<SampleInterval> &intervals, int clusters, int perCluster)
+{
+    mt19937 random(2);
+    vector<int> samples;
+    for (int c = 0; c < clusters; c++)
+    {
+        vector<int> members;
+        vector<double> centre;
+        for (int i = 0; i < (int)intervals.size(); i++)
+        {
+            if (intervals[i].cluster != c)
+                continue;
+            members.push_back(i);
+            if (centre.empty())
+                centre.assign(intervals[i].bbv.size(), 0.0);
+            for (size_t b = 0; b < centre.size(); b++)
+                centre[b] += intervals[i].bbv[b];
+        }
+        if (members.empty())
+            continue;
+        for (double &value : centre)
+            value /= members.size();
+        // The representative in SimPoint's sense first
+        int closest = 0;
+        for (size_t m = 1; m < members.size(); m++)
+            if (distance2(intervals[members[m]].bbv, centre) < distance2(intervals[members[closest]].bbv, centre))
+                closest = m;
+        swap(members[0], members[closest]);
+        shuffle(members.begin() + 1, members.end(), random);
+        members.resize(min((int)members.size(), perCluster));
+        samples.insert(samples.end(), members.begin(), members.end());
+    }
+    sort(samples.begin(), samples.end());
+    return samples;
+}
+
+void ReportSamples(ostream &out, const vector<SampleInterval> &intervals, int clusters, const vector<int> &samples,
+                   const vector<long> &cycles)
+{
+    long total = 0, detailed = 0;
+    for (const SampleInterval &interval : intervals)
+        total += interval.length;
+    out << "Sampling: " << intervals.size() << " intervals, " << total << " instructions, " << clusters << " clusters" << endl;
+
+    // Stratified estimate: the clusters are the strata, weighted by their
+    // share of the instructions; a cluster's CPI is the mean of its samples
+    double estimate = 0, variance = 0;
+    bool bounded = true;
+    for (int c = 0; c < clusters; c++)
+    {
+        long clusterInstrs = 0;
+        int members = 0;
+        for (const SampleInterval &interval : intervals)
+            if (interval.cluster == c)
+            {
+                clusterInstrs += interval.length;
+                members++;
+            }
+        vector<double> cpis;
+        out << "  cluster " << c << ": " << members << " intervals (" << 100.0 * clusterInstrs / total << "% of instructions), samples";
+        for (size_t s = 0; s < samples.size(); s++)
+        {
+            const SampleInterval &interval = intervals[samples[s]];
+            if (interval.cluster != c || cycles[s] < 0)
+                continue;
+            cpis.push_back((double)cycles[s] / interval.length);
+            detailed += interval.length;
+            out << " " << samples[s] << " (CPI " << cpis.back() << ")";
+        }
+        out << endl;
+        if (cpis.empty())
+        {
+            bounded = false;
+            continue;
+        }
+        double mean = 0;
+        for (double cpi : cpis)
+            mean += cpi;
+        mean /= cpis.size();
+        double weight = (double)clusterInstrs / total;
+        estimate += weight * mean;
+
+        int n = cpis.size();
+        if (n == members)
+            continue; // Every interval of the cluster was simulated
+        if (n < 2)
+        {
+            bounded = false;
+            continue;
+        }
+        double spread = 0;
+        for (double cpi : cpis)
+            spread += (cpi - mean) * (cpi - mean);
+        spread /= n - 1;
+        variance += weight * weight * spread / n * (1.0 - (double)n / members);
+    }
+
+    out << "Estimated CPI " << estimate;
+    if (bounded)
+        out << " +- " << 1.96 * sqrt(variance) << " (95%)";
+    else
+        out << " (no error bound: every cluster needs two samples, see --sample-per-cluster)";
+    out << " from " << detailed << " instructions simulated in detail (" << 100.0 * detailed / total << "%)" << endl;
+}
@@ -0,0 +1,69 @@
+#ifndef SAMPLING_HPP
+#define SAMPLING_HPP
+
+#include <ostream>
+#include <vector>
+#include "Processor.hpp"
+
+// Sampled simulation (--sample), after SimPoint: a profiling pass executes
+// the program without timing and records a basic-block vector (instructions
+// executed per basic block) for every interval of a fixed number of
+// instructions. The vectors are clustered with k-means, a few intervals of
+// every cluster are simulated in detail, and the CPI of the whole run is
+// estimated from them, weighted by cluster size.
+struct SampleConfig
+{
+    long interval = 0;  // Instructions per interval; 0 disables sampling
+    int clusters = 8;   // k-means clusters (at most one per interval)
+    int perCluster = 2; // Intervals simulated in detail per cluster
+    long warmup = 0;    // Instructions simulated in detail before each interval, not counted
+};
+
+struct SampleInterval
+{
+    long start;              // Instructions executed before it
+    long length;             // Instructions in it (the last one may be short)
+    std::vector<double> bbv; // Share of its instructions in each basic block
+    int cluster;
+};
+
+// Profiling pass: execute up to maxInstrs instructions of cpu.program from
+// instruction 0 and cut them into intervals
+std::vector<SampleInterval> ProfileIntervals(Processor &cpu, long interval, long maxInstrs);
+
+// k-means++ on the basic-block vectors; sets every interval's cluster and
+// returns the number of clusters used
+int ClusterIntervals(std::vector<SampleInterval> &intervals, int clusters);
+
+// Intervals to simulate in detail: per cluster the one closest to its
+// centre, then others of the cluster picked at random (fixed seed)
+std::vector<int> PickSamples(const std::vector<SampleInterval> &intervals, int clusters, int perCluster);
+
+// Print the clusters, the CPI of every sample and the weighted CPI estimate
+// with its 95% error bound (stratified sampling over the clusters)
+void ReportSamples(std::ostream &out, const std::vector<SampleInterval> &intervals, int clusters,
+                   const std::vector<int> &samples, const std::vector<long> &cycles);
+
+// Clock a cpu restored to the start of a sample until `warmup` and then
+// `length` more instructions have retired. Returns the cycles taken by the
+// last `length`, or -1 if they did not retire within a generous limit.
+template <typename Core>
+long TimeInstructions(Core &cpu, long warmup, long length)
+{
+    long retired = 0, started = 0;
+    long limit = 100 * (warmup + length) + 1000;
+    for (long cycle = 1; cycle <= limit; cycle++)
+    {
+        cpu.Cycle();
+        if (cpu.WB.InStr == -1)
+            continue;
+        retired++;
+        if (retired == warmup)
+            started = cycle;
+        if (retired == warmup + length)
+            return cycle - started;
+    }
+    return -1;
+}
+
+#endif
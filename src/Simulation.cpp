@@ -0,0 +1,109 @@
+#include "Simulation.hpp"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+using namespace std;
+
+static vector<string> splitLine(const string &line)
+{
+    vector<string> words;
+    stringstream ss(line);
+    string word;
+    while (ss >> word)
+    {
+        words.push_back(word);
+    }
+    return words;
+}
+
+bool LoadProgram(const string &path, Program &program)
+{
+    ifstream file(path);
+    if (!file)
+        return false;
+
+    // Every line is decoded once here; ID only indexes this array.
+    string line;
+    while (getline(file, line))
+    {
+        vector<string> words = splitLine(line);
+        if (words.size() >= 2)
+        {
+            program.code.push_back(Predecode(words[0]));
+            string instruction;
+            for (size_t i = 1; i < words.size(); i++)
+            {
+                // Stop concatenating if you hit a comment token.
+                if (!words[i].empty() && words[i][0] == '#')
+                {
+                    break;
+                }
+                if (!instruction.empty())
+                {
+                    instruction += " ";
+                }
+                instruction += words[i];
+            }
+            program.text.push_back(instruction);
+        }
+    }
+    return true;
+}
+
+string OutputFileName(const string &inputFile, const string &mode, const string &dir)
+{
+    // Find the last slash to get the filename
+    size_t last_slash = inputFile.find_last_of("/");
+    string filename = (last_slash == string::npos) ? inputFile : inputFile.substr(last_slash + 1);
+
+    return dir + "/" + filename.substr(0, filename.find_last_of('.')) + "_" + mode + "_out.txt";
+}
+
+bool WriteDiagramFile(const string &path, const PipelineDiagram &diagram, const vector<string> &labels)
+{
+    ofstream outfile(path);
+    if (!outfile)
+    {
+        cerr << "Error: Unable to open output file " << path << endl;
+        return false;
+    }
+    diagram.Write(outfile, labels);
+    return true;
+}
+
+string JsonQuote(const string &text)
+{
+    string quoted = "\"";
+    for (char c : text)
+    {
+        if (c == '"' || c == '\\')
+            quoted += '\\';
+        quoted += ((unsigned char)c < 0x20) ? ' ' : c;
+    }
+    return quoted + "\"";
+}
+
+string CsvField(const string &text)
+{
+    string field = "\"";
+    for (char c : text)
+        field += (c == '"') ? string("\"\"") : string(1, c);
+    return field + "\"";
+}
+
+bool WriteCpiStackFile(const string &path, const CpiStack &stack, const vector<string> &labels)
+{
+    ofstream outfile(path);
+    if (!outfile)
+    {
+        cerr << "Error: Unable to open output file " << path << endl;
+        return false;
+    }
+    if (path.size() >= 5 && path.compare(path.size() - 5, 5, ".json") == 0)
+        stack.WriteJson(outfile, labels);
+    else
+        stack.WriteCsv(outfile, labels);
+    return true;
+}
@@ -0,0 +1,95 @@
+#ifndef SIMULATION_HPP
+#define SIMULATION_HPP
+
+#include <functional>
+#include <string>
+#include <vector>
+#include "Predecode.hpp"
+#include "PipelineDiagram.hpp"
+#include "CpiStack.hpp"
+
+// Shared by the forward / noforward simulators and the batch runner
+
+// A predecoded program plus the assembly text used as diagram row labels
+struct Program
+{
+    std::vector<DecodedInstr> code;
+    std::vector<std::string> text;
+};
+
+// Read "<hex> <assembly...> [# comment]" lines; false if the file cannot be opened
+bool LoadProgram(const std::string &path, Program &program);
+
+// <dir>/<input name without extension>_<mode>_out.txt
+std::string OutputFileName(const std::string &inputFile, const std::string &mode, const std::string &dir = "../outputfiles");
+
+// Write the diagram to path; false (after printing an error) if it cannot be opened
+bool WriteDiagramFile(const std::string &path, const PipelineDiagram &diagram, const std::vector<std::string> &labels);
+
+// text as a JSON string literal
+std::string JsonQuote(const std::string &text);
+
+// text as a quoted CSV field
+std::string CsvField(const std::string &text);
+
+// Write the CPI stack to path, as JSON if it ends in ".json" and CSV
+// otherwise; false (after printing an error) if it cannot be opened
+bool WriteCpiStackFile(const std::string &path, const CpiStack &stack, const std::vector<std::string> &labels);
+
+// Summary of one timed run, counted over the rendered cycles
+struct RunStats
+{
+    long cycles;  // Cycles until the pipeline drained (or the budget ran out)
+    long retired; // Instructions that reached WB
+    long stalls;  // Cycles in which fetch was held by a hazard
+
+    double CPI() const { return retired ? (double)cycles / retired : 0.0; }
+};
+
+// Called after each recorded cycle with the number of cycles run so far
+typedef std::function<void(long cycles)> CycleHook;
+
+// Clock cpu for numCycles (+ Core::DRAIN_CYCLES) cycles, recording the
+// first numCycles of them in diagram
+template <typename Core>
+RunStats RunPipeline(Core &cpu, PipelineDiagram &diagram, int numCycles, const CycleHook &afterCycle = CycleHook())
+{
+    RunStats stats = {0, 0, 0};
+    int shown[5] = {-1, -1, -1, -1, -1}; // Instruction in IF..WB this cycle
+    for (int cycle = 0; cycle < numCycles + Core::DRAIN_CYCLES; cycle++)
+    {
+        if (!cpu.MemoryStalled())
+        {
+            shown[0] = cpu.IF.PC;
+            shown[1] = cpu.IF.InStr;
+            shown[2] = cpu.ID.InStr;
+            shown[3] = cpu.EX.InStr;
+            shown[4] = cpu.DM.InStr;
+        }
+        else
+        {
+            // A data cache miss holds the pipeline: every instruction stays
+            // where it was (rendered as '-') and WB is empty
+            shown[4] = -1;
+        }
+        for (int stage = 5; stage >= 1; stage--)
+            diagram.Record(cycle, shown[stage - 1], stage);
+        int fetchPC = cpu.IF.PC;
+        cpu.Cycle();
+        if (cycle < numCycles)
+        {
+            if (cpu.WB.InStr != -1)
+                stats.retired++;
+            // A held fetch keeps both its PC and its instruction
+            if (cpu.IF.PC == fetchPC && cpu.IF.InStr != -1)
+                stats.stalls++;
+            if (cpu.WB.InStr != -1 || cpu.DM.InStr != -1 || cpu.EX.InStr != -1 || cpu.ID.InStr != -1 || cpu.IF.InStr != -1)
+                stats.cycles = cycle + 1;
+            if (afterCycle)
+                afterCycle(cycle + 1);
+        }
+    }
+    return stats;
+}
+
+#endif
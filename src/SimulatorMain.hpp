@@ -0,0 +1,308 @@
+#ifndef SIMULATOR_MAIN_HPP
+#define SIMULATOR_MAIN_HPP
+
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <algorithm>
+#include <sstream>
+#include <vector>
+#include <climits>
+#include <fstream>
+#include <memory>
+#include <type_traits>
+#include "PipelineDiagram.hpp"
+#include "Functional.hpp"
+#include "Options.hpp"
+#include "Checkpoint.hpp"
+#include "BinaryTrace.hpp"
+#include "ChromeTrace.hpp"
+#include "KanataTrace.hpp"
+#include "HotProfile.hpp"
+#include "Sampling.hpp"
+#include "Simulation.hpp"
+#include "Superscalar.hpp"
+#include "OutOfOrder.hpp"
+
+// Instructions --ff-pc executes looking for its target when --ff gives no bound
+const long FF_PC_LIMIT = 100000000;
+
+// Timed run of an already configured cpu (the 5-stage Core, the
+// superscalar or the out-of-order core), with optional fast-forward, and
+// for the 5-stage Core optional checkpoints, CPI stack and profile. Traces
+// are streamed from the diagram records as the run goes.
+template <typename Cpu>
+int SimulateDetailed(Cpu &cpu, const SimOptions &options, const Program &program, const std::string &mode, bool showSlots)
+{
+    int total_instructions = program.code.size();
+    int numCycles = options.numCycles;
+    if (options.ffInstrs >= 0 || options.ffPC >= 0)
+    {
+        // Fast-forward: run the setup code architecturally, then hand RegFile,
+        // MEM and the PC over to the pipeline. The diagram only covers the
+        // detailed window that follows.
+        int pc = 0;
+        long budget = (options.ffInstrs >= 0) ? options.ffInstrs : (options.ffPC >= 0) ? FF_PC_LIMIT : LONG_MAX;
+        long executed = RunFunctional(cpu, pc, budget, options.ffPC);
+        if (options.ffPC >= 0 && pc != options.ffPC)
+        {
+            std::cerr << "Error: --ff-pc " << options.ffPC << " was not reached in " << executed << " instructions" << std::endl;
+            return 1;
+        }
+        cpu.IF.PC = pc;
+        std::cout << "Fast-forwarded " << executed << " instructions; detailed simulation starts at instruction " << pc << std::endl;
+    }
+    if (!options.restoreFile.empty())
+    {
+        if (!ReadCheckpoint(cpu, mode, options.restoreFile))
+        {
+            return 1;
+        }
+        std::cout << "Restored " << options.restoreFile << "; detailed simulation resumes at cycle " << cpu.Cycles() << std::endl;
+    }
+
+    // The checkpoint is taken after the last rendered cycle, before the
+    // pipeline drains, so the next interval starts where this one ended
+    bool saved = true;
+    bool checkpoint = !options.checkpointFile.empty();
+    bool attribute = !options.cpiStackFile.empty() || options.profile;
+    CpiStack stack(attribute ? total_instructions : 0);
+    HotProfile profile(options.profile ? total_instructions : 0);
+    if (options.profile && numCycles > 0)
+        profile.Occupy(cpu);
+
+    // Stall reasons are only known for the 5-stage pipeline
+    constexpr bool fiveStage = !std::is_base_of<TimingCore, Cpu>::value;
+    std::ofstream traceOut;
+    std::unique_ptr<ChromeTrace> trace;
+    if (!options.traceFile.empty())
+    {
+        traceOut.open(options.traceFile);
+        if (!traceOut)
+        {
+            std::cerr << "Error: Unable to open output file " << options.traceFile << std::endl;
+            return 1;
+        }
+        trace.reset(new ChromeTrace(traceOut, program.text, options.inputFile + " (" + mode + ")", showSlots));
+    }
+    std::ofstream kanataOut;
+    std::unique_ptr<KanataTrace> kanata;
+    if (!options.kanataFile.empty())
+    {
+        kanataOut.open(options.kanataFile);
+        if (!kanataOut)
+        {
+            std::cerr << "Error: Unable to open output file " << options.kanataFile << std::endl;
+            return 1;
+        }
+        kanata.reset(new KanataTrace(kanataOut, program.text));
+    }
+    // The binary trace replaces the diagram file; ./render writes it
+    std::ofstream binaryOut;
+    std::unique_ptr<BinaryTraceWriter> binary;
+    if (!options.binTraceFile.empty())
+    {
+        binaryOut.open(options.binTraceFile, std::ios::binary);
+        if (!binaryOut)
+        {
+            std::cerr << "Error: Unable to open output file " << options.binTraceFile << std::endl;
+            return 1;
+        }
+        BinaryTraceHeader header = {options.inputFile + " (" + mode + ")", program.text, numCycles, showSlots,
+                                    !std::is_same<Cpu, OutOfOrderCore>::value};
+        binary.reset(new BinaryTraceWriter(binaryOut, header));
+    }
+
+    CycleHook afterCycle;
+    if (checkpoint || attribute || (trace && fiveStage))
+    {
+        afterCycle = [&](long cycles) {
+            if (attribute)
+                stack.Count(cpu);
+            if (trace && fiveStage)
+                trace->Stall(cycles - 1, cpu.SlotReason(), cpu.SlotInstr());
+            if (options.profile)
+            {
+                profile.Retire(cpu);
+                if (cycles < numCycles)
+                    profile.Occupy(cpu);
+            }
+            if (checkpoint && (cycles == numCycles || (options.checkpointEvery > 0 && cycles % options.checkpointEvery == 0)))
+                saved = WriteCheckpoint(cpu, mode, options.checkpointFile) && saved;
+        };
+    }
+    if (checkpoint && numCycles == 0)
+        saved = WriteCheckpoint(cpu, mode, options.checkpointFile);
+
+    PipelineDiagram diagram(total_instructions, numCycles, showSlots);
+    if (trace)
+        diagram.Attach(trace.get());
+    if (kanata)
+        diagram.Attach(kanata.get());
+    if (binary)
+    {
+        diagram.Attach(binary.get());
+        diagram.TraceOnly();
+    }
+    RunPipeline(cpu, diagram, numCycles, afterCycle);
+    auto finish = [&](PipelineTrace &t, std::ofstream &out, const std::string &path) {
+        t.Finish();
+        if (!out.flush())
+        {
+            std::cerr << "Error: Unable to write " << path << std::endl;
+            saved = false;
+        }
+    };
+    if (trace)
+        finish(*trace, traceOut, options.traceFile);
+    if (kanata)
+        finish(*kanata, kanataOut, options.kanataFile);
+    if (binary)
+        finish(*binary, binaryOut, options.binTraceFile);
+    cpu.ReportPredictors(std::cout);
+    cpu.ReportCaches(std::cout);
+    if (!options.cpiStackFile.empty())
+    {
+        stack.Report(std::cout);
+        saved = WriteCpiStackFile(options.cpiStackFile, stack, program.text) && saved;
+    }
+    if (options.profile)
+    {
+        profile.Report(std::cout, program.text, stack);
+        std::string path = OutputFileName(options.inputFile, mode + "_profile");
+        std::ofstream out(path);
+        if (out)
+            profile.Write(out, program.text, stack);
+        else
+        {
+            std::cerr << "Error: Unable to open output file " << path << std::endl;
+            saved = false;
+        }
+    }
+
+    if ((!binary && !WriteDiagramFile(OutputFileName(options.inputFile, mode), diagram, program.text)) || !saved)
+    {
+        return 1;
+    }
+    return 0;
+}
+
+// --sample: profile the program, then time the chosen intervals on Core.
+// A second functional pass walks to the start of each sample's warm-up and
+// hands its state to a fresh Core through SaveState/RestoreState.
+template <typename Core>
+int SimulateSampled(const SimOptions &options, const Program &program)
+{
+    const SampleConfig &config = options.sample;
+    Core profile(program.code);
+    auto start = std::chrono::steady_clock::now();
+    std::vector<SampleInterval> intervals = ProfileIntervals(profile, config.interval, options.numCycles);
+    int clusters = ClusterIntervals(intervals, config.clusters);
+    std::vector<int> samples = PickSamples(intervals, clusters, config.perCluster);
+    std::chrono::duration<double> profiled = std::chrono::steady_clock::now() - start;
+
+    Core walker(program.code);
+    int pc = 0;
+    long executed = 0;
+    std::vector<long> cycles;
+    for (int s : samples)
+    {
+        long from = std::max(0L, intervals[s].start - config.warmup);
+        executed += RunFunctional(walker, pc, from - executed);
+        walker.IF.PC = pc;
+        std::stringstream state;
+        walker.SaveState(state);
+
+        Core cpu(program.code);
+        cpu.ConfigurePredictors(options.predictor);
+        cpu.ConfigureCaches(options.caches);
+        cpu.muldiv = options.muldiv;
+        cpu.RestoreState(state);
+        cycles.push_back(TimeInstructions(cpu, intervals[s].start - from, intervals[s].length));
+    }
+    std::chrono::duration<double> total = std::chrono::steady_clock::now() - start;
+
+    ReportSamples(std::cout, intervals, clusters, samples, cycles);
+    std::cerr << "Profiling " << profiled.count() << " s, detailed samples " << (total - profiled).count() << " s" << std::endl;
+    return 0;
+}
+
+// main() of the forward / noforward simulators for pipeline type Core;
+// mode names the output file (<input>_<mode>_out.txt). With --ooo the
+// out-of-order core runs instead, and with --width above 1 or --depth the
+// superscalar core, bypassing as Core does.
+template <typename Core>
+int SimulatorMain(int argc, char **argv, const std::string &mode)
+{
+    SimOptions options;
+    if (!ParseOptions(argc, argv, options))
+    {
+        return 1;
+    }
+
+    Program program;
+    if (!LoadProgram(options.inputFile, program))
+    {
+        std::cerr << "Error: Unable to open input file " << options.inputFile << std::endl;
+        return 1;
+    }
+
+    if (options.functional)
+    {
+        // Architectural results only: num_cycles is the instruction budget
+        Core cpu(program.code);
+        int pc = 0;
+        auto start = std::chrono::steady_clock::now();
+        long executed = RunFunctional(cpu, pc, options.numCycles);
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        std::cout << "Instructions: " << executed << "\n";
+        std::cout << "PC: " << pc << "\n";
+        DumpArchState(cpu, std::cout);
+        std::cerr << executed / elapsed.count() / 1e6 << " MIPS" << std::endl;
+        return 0;
+    }
+
+    if (options.sample.interval > 0)
+    {
+        return SimulateSampled<Core>(options, program);
+    }
+    if (options.outOfOrder)
+    {
+        OutOfOrderCore cpu(program.code, options.width, options.ooo, Core::BYPASS_EX);
+        cpu.ConfigurePredictors(options.predictor);
+        cpu.ConfigureCaches(options.caches);
+        cpu.muldiv = options.muldiv;
+        if (SimulateDetailed(cpu, options, program, mode, false) != 0)
+        {
+            return 1;
+        }
+        cpu.Report(std::cout);
+
+        // Per-instruction dispatch/issue/complete/commit cycles
+        std::string path = OutputFileName(options.inputFile, mode + "_timeline");
+        std::ofstream timeline(path);
+        if (!timeline)
+        {
+            std::cerr << "Error: Unable to open output file " << path << std::endl;
+            return 1;
+        }
+        cpu.WriteTimeline(timeline, program.text);
+        return 0;
+    }
+    if (options.width > 1 || !options.depth.IsDefault())
+    {
+        SuperscalarCore cpu(program.code, options.width, Core::BYPASS_EX, Core::BYPASS_ID, options.depth);
+        cpu.ConfigurePredictors(options.predictor);
+        cpu.ConfigureCaches(options.caches);
+        cpu.muldiv = options.muldiv;
+        return SimulateDetailed(cpu, options, program, mode, options.width > 1);
+    }
+    Core cpu(program.code);
+    cpu.ConfigurePredictors(options.predictor);
+    cpu.ConfigureCaches(options.caches);
+    cpu.muldiv = options.muldiv;
+    return SimulateDetailed(cpu, options, program, mode, false);
+}
+
+#endif
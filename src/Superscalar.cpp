@@ -0,0 +1,244 @@
+#include "Superscalar.hpp"
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <vector>
+using namespace std;
+
+bool ParsePipelineDepth(const string &spec, PipelineDepth &depth)
+{
+    stringstream ss(spec);
+    string item;
+    while (getline(ss, item, ','))
+    {
+        size_t eq = item.find('=');
+        if (eq == string::npos)
+            return false;
+        string key = item.substr(0, eq);
+        int stages = atoi(item.substr(eq + 1).c_str());
+        if (stages < 1 || stages > 4)
+            return false;
+        if (key == "if")
+            depth.fetch = stages;
+        else if (key == "ex")
+            depth.execute = stages;
+        else if (key == "mem")
+            depth.memory = stages;
+        else
+            return false;
+    }
+    return true;
+}
+
+SuperscalarCore::SuperscalarCore(const vector<DecodedInstr> &program, int width, bool bypassEX, bool bypassID,
+                                 const PipelineDepth &depth)
+    : TimingCore(program, width), bypassEX(bypassEX), bypassID(bypassID), depth(depth), fetching(depth.fetch - 1),
+      executing(depth.execute), memory(depth.memory), issueStalled(false)
+{
+    for (int i = 0; i < 32; i++)
+    {
+        exReady[i] = 0;
+        dataReady[i] = 0;
+        idReady[i] = 0;
+        unitReady[i] = 0;
+    }
+}
+
+void SuperscalarCore::Cycle()
+{
+    now++;
+    // Waiting on a data cache miss: nothing moves and WB sees bubbles
+    if (memStall > 0)
+    {
+        memStall--;
+        writeback.clear();
+        issueStalled = false;
+        return;
+    }
+    writeback.swap(memory.back());
+    process_MEM();
+    process_ID();
+    process_IF();
+}
+
+bool SuperscalarCore::Busy() const
+{
+    if (!fetched.empty() || !decoded.empty() || !writeback.empty())
+        return true;
+    for (const vector<vector<Op>> *stages : {&fetching, &executing, &memory})
+        for (const vector<Op> &bundle : *stages)
+            if (!bundle.empty())
+                return true;
+    return false;
+}
+
+// Later stages first, so an instruction fetched again while an older copy
+// is still in flight shows its fetch, as in RunPipeline
+void SuperscalarCore::Record(PipelineDiagram &diagram, int cycle) const
+{
+    auto record = [&](const vector<Op> &bundle, int stage, int part) {
+        for (size_t slot = 0; slot < bundle.size(); slot++)
+            diagram.Record(cycle, bundle[slot].InStr, stage, slot, part);
+    };
+    // stages[k] is sub-stage first + k; they are numbered only when the
+    // stage is split
+    auto recordSplit = [&](const vector<vector<Op>> &stages, int stage, int first) {
+        bool split = first + stages.size() > 2;
+        for (size_t k = stages.size(); k-- > 0;)
+            record(stages[k], stage, split ? first + k : 0);
+    };
+    record(writeback, 5, 0);
+    recordSplit(memory, 4, 1);
+    recordSplit(executing, 3, 1);
+    record(decoded, 2, 0);
+    recordSplit(fetching, 1, 2);
+    RecordFetch(diagram, cycle, fetching.empty() ? 0 : 1);
+}
+
+// Bundles move one stage on; the load or store (there is at most one) of
+// the bundle entering MEM1 looks up the L1D, and a miss holds the pipeline
+// as in the 5-stage core
+void SuperscalarCore::process_MEM()
+{
+    // Cycle() has swapped the last MEM bundle into WB; the stale bundle it
+    // left behind rotates down to EX1 and is cleared there
+    for (size_t k = memory.size() - 1; k > 0; k--)
+        memory[k].swap(memory[k - 1]);
+    memory[0].swap(executing.back());
+    for (size_t k = executing.size() - 1; k > 0; k--)
+        executing[k].swap(executing[k - 1]);
+    executing[0].clear();
+    for (const Op &op : memory[0])
+    {
+        const DecodedInstr &instr = program[op.InStr];
+        if (dcache && (instr.MemRead || instr.MemWrite))
+            memStall = dcache->Access(op.out.address, instr.MemWrite, now, op.InStr) - 1;
+    }
+    if (memStall <= 0)
+        return;
+
+    // Nothing moves while the pipeline is held, so results still on their
+    // way through the stages (and a pending I-cache refill) arrive that much
+    // later; the multiplier and divider keep running
+    for (int reg = 0; reg < 32; reg++)
+    {
+        if (exReady[reg] > now)
+            exReady[reg] += memStall;
+        if (dataReady[reg] > now)
+            dataReady[reg] += memStall;
+        if (idReady[reg] > now)
+            idReady[reg] += memStall;
+    }
+    if (fetchResume > now && fetchResume != LONG_MAX)
+        fetchResume += memStall;
+}
+
+// instr spent the previous cycle in ID; can it enter EX this cycle?
+bool SuperscalarCore::canIssue(const DecodedInstr &instr, bool memPortUsed) const
+{
+    if (instr.Class == CLASS_BRANCH || instr.Class == CLASS_JALR)
+    {
+        if ((instr.RR1 > 0 && idReady[instr.RR1] > now - 1) || (instr.RR2 > 0 && idReady[instr.RR2] > now - 1))
+            return false;
+    }
+    else
+    {
+        if (instr.RR1 > 0 && exReady[instr.RR1] > now)
+            return false;
+        if (instr.RR2 > 0 && (instr.MemWrite ? dataReady[instr.RR2] : exReady[instr.RR2]) > now)
+            return false;
+    }
+    // As Processor::mulDivHazard
+    if ((instr.RR1 > 0 && unitReady[instr.RR1] > now) || (instr.RR2 > 0 && unitReady[instr.RR2] > now))
+        return false;
+    if ((instr.MemRead || instr.MemWrite) && memPortUsed)
+        return false;
+    return !(instr.Class == CLASS_ALU && IsDivide(instr.ALUOp) && divFreeAt > now);
+}
+
+// Record when the result of instr, entering EX1 this cycle, can be used
+void SuperscalarCore::book(const DecodedInstr &instr)
+{
+    long start = now;
+    long unitDone = 0;
+    if (instr.Class == CLASS_ALU && IsMultiply(instr.ALUOp))
+        unitDone = start + muldiv.mulLatency;
+    else if (instr.Class == CLASS_ALU && IsDivide(instr.ALUOp))
+    {
+        unitDone = start + muldiv.divLatency;
+        divFreeAt = unitDone;
+    }
+    if (!instr.RegWrite || instr.WR == 0)
+        return;
+
+    // Through the stages: bypassed once it has left the last EX stage (the
+    // last MEM stage for a load), or written back in WB and read by ID in
+    // the same cycle
+    long bypassed = start + depth.execute + (instr.MemRead ? depth.memory : 0);
+    long inRegFile = start + depth.execute + depth.memory;
+    exReady[instr.WR] = bypassEX ? bypassed : inRegFile + 1;
+    // Store data is only needed in MEM1: a result can be bypassed to it there
+    dataReady[instr.WR] = bypassEX ? max(start + 1, bypassed - depth.execute) : exReady[instr.WR];
+    idReady[instr.WR] = bypassID ? bypassed : inRegFile;
+    unitReady[instr.WR] = unitDone;
+}
+
+// Move the oldest instructions of the ID bundle into EX in order, then
+// refill ID from IF
+void SuperscalarCore::process_ID()
+{
+    bool memPortUsed = false;
+    size_t issued = 0;
+    issueStalled = false;
+    for (; issued < decoded.size(); issued++)
+    {
+        const Op &op = decoded[issued];
+        const DecodedInstr &instr = program[op.InStr];
+        if (!canIssue(instr, memPortUsed))
+        {
+            issueStalled = true;
+            break;
+        }
+        memPortUsed |= (instr.MemRead || instr.MemWrite);
+        book(instr);
+        // It resolved in ID last cycle; fetch may continue this cycle
+        if (IsControl(instr))
+            resolve(op, instr, now);
+        executing[0].push_back(op);
+    }
+    decoded.erase(decoded.begin(), decoded.begin() + issued);
+
+    // Refill ID from the last IF stage, then move each fetch group on to an
+    // IF stage that has emptied
+    vector<Op> &last = fetching.empty() ? fetched : fetching.back();
+    size_t moved = 0;
+    while (moved < last.size() && (int)decoded.size() < width)
+        decoded.push_back(last[moved++]);
+    last.erase(last.begin(), last.begin() + moved);
+    for (size_t k = fetching.size(); k-- > 0;)
+    {
+        vector<Op> &from = (k == 0) ? fetched : fetching[k - 1];
+        if (fetching[k].empty())
+            fetching[k].swap(from);
+    }
+}
+
+RunStats RunPipeline(SuperscalarCore &cpu, PipelineDiagram &diagram, int numCycles, const CycleHook &afterCycle)
+{
+    RunStats stats = {0, 0, 0};
+    for (int cycle = 0; cycle < numCycles; cycle++)
+    {
+        cpu.Cycle();
+        cpu.Record(diagram, cycle);
+        stats.retired += cpu.Retired();
+        if (cpu.IssueStalled())
+            stats.stalls++;
+        if (cpu.Busy())
+            stats.cycles = cycle + 1;
+        if (afterCycle)
+            afterCycle(cycle + 1);
+    }
+    return stats;
+}
@@ -0,0 +1,86 @@
+#ifndef SUPERSCALAR_HPP
+#define SUPERSCALAR_HPP
+
+#include <string>
+#include <vector>
+#include "TimingCore.hpp"
+#include "PipelineDiagram.hpp"
+#include "Simulation.hpp"
+
+// Stage counts for --depth: IF, EX and MEM may each be split into several
+// stages (IF1, IF2, ...); ID and WB are always one stage
+struct PipelineDepth
+{
+    int fetch = 1;
+    int execute = 1;
+    int memory = 1;
+
+    bool IsDefault() const { return fetch == 1 && execute == 1 && memory == 1; }
+};
+
+// Parse "if=2,ex=2,mem=2" (any subset, each 1..4); returns false if invalid
+bool ParsePipelineDepth(const std::string &spec, PipelineDepth &depth);
+
+// N-wide in-order version of the 5-stage pipeline, optionally deepened.
+// Every stage latch holds up to `width` instructions (one per slot); IF1 is
+// the TimingCore front end.
+//   IF2.. move the fetch group on once the stage ahead has emptied
+//   ID   passes the oldest instructions to EX in order while their operands are
+//        available: a per-register scoreboard says when a result can be
+//        bypassed into EX (or ID, for branches and JALR) from any slot, so
+//        an instruction that needs the result of an older one in the same
+//        bundle waits a cycle. At most one load/store issues per cycle
+//        (one memory port), and a division waits for the divider. Branches
+//        and jumps resolve when they leave ID, as in the 5-stage pipeline,
+//        so every extra IF stage adds a cycle to the cost of a branch fetch
+//        had to wait for.
+//   EX, MEM, WB move whole bundles; MEM1 looks up the L1D.
+// Results are bypassed from the end of the last EX stage (the last MEM stage
+// for loads), so the scoreboard distances grow with the EX and MEM depth.
+// The bypass flags follow the forwarding policy of the binary.
+class SuperscalarCore : public TimingCore
+{
+public:
+    SuperscalarCore(const std::vector<DecodedInstr> &program, int width, bool bypassEX, bool bypassID,
+                    const PipelineDepth &depth = PipelineDepth());
+
+    // Advance one clock cycle
+    void Cycle();
+
+    // Mark every instruction in flight this cycle in diagram, with its slot
+    void Record(PipelineDiagram &diagram, int cycle) const;
+
+    // Instructions that reached WB this cycle
+    int Retired() const { return writeback.size(); }
+    // The oldest instruction in ID could not issue this cycle
+    bool IssueStalled() const { return issueStalled; }
+    // Any stage holds an instruction
+    bool Busy() const;
+
+private:
+    bool bypassEX;
+    bool bypassID;
+    PipelineDepth depth;
+
+    std::vector<std::vector<Op>> fetching;  // IF2.., oldest first within each
+    std::vector<Op> decoded;                // ID
+    std::vector<std::vector<Op>> executing; // EX1..
+    std::vector<std::vector<Op>> memory;    // MEM1..
+    std::vector<Op> writeback;              // WB
+
+    long exReady[32];   // First cycle a consumer of the register may enter EX
+    long dataReady[32]; // Same, for a store that only needs it as data
+    long idReady[32];   // First cycle a branch/JALR in ID may read it
+    long unitReady[32]; // First cycle the multiplier/divider result can be used
+    bool issueStalled;
+
+    void process_MEM();
+    void process_ID();
+    bool canIssue(const DecodedInstr &instr, bool memPortUsed) const;
+    void book(const DecodedInstr &instr);
+};
+
+// RunPipeline for the superscalar core: numCycles cycles, all recorded
+RunStats RunPipeline(SuperscalarCore &cpu, PipelineDiagram &diagram, int numCycles, const CycleHook &afterCycle = CycleHook());
+
+#endif
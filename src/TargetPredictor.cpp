@@ -0,0 +1,69 @@
+#include "TargetPredictor.hpp"
+#include <ostream>
+using namespace std;
+
+BranchTargetBuffer::BranchTargetBuffer(int entries)
+    : tags(entries, -1), targets(entries, 0), mask(entries - 1)
+{
+}
+
+bool BranchTargetBuffer::Lookup(int pc, int &target)
+{
+    lookups++;
+    int slot = pc & mask;
+    if (tags[slot] != pc)
+        return false;
+    hits++;
+    target = targets[slot];
+    return true;
+}
+
+void BranchTargetBuffer::Update(int pc, int target, int predicted)
+{
+    if (predicted != -1 && predicted != target)
+        wrongTargets++;
+    int slot = pc & mask;
+    tags[slot] = pc;
+    targets[slot] = target;
+}
+
+void BranchTargetBuffer::Report(ostream &out) const
+{
+    out << "BTB: " << lookups << " lookups, " << hits << " hits ("
+        << (lookups ? 100.0 * hits / lookups : 0.0) << "%), " << wrongTargets << " wrong targets" << endl;
+}
+
+ReturnAddressStack::ReturnAddressStack(int depth)
+    : entries(depth, 0), top(0), count(0)
+{
+}
+
+void ReturnAddressStack::Push(int link)
+{
+    entries[top] = link;
+    top = (top + 1) % entries.size();
+    if (count < (int)entries.size())
+        count++;
+    else
+        overflows++;
+}
+
+bool ReturnAddressStack::Pop(int &link)
+{
+    if (count == 0)
+    {
+        underflows++;
+        return false;
+    }
+    top = (top + entries.size() - 1) % entries.size();
+    count--;
+    link = entries[top];
+    return true;
+}
+
+void ReturnAddressStack::Report(ostream &out) const
+{
+    out << "RAS: " << returns << " returns predicted, " << correct << " correct ("
+        << (returns ? 100.0 * correct / returns : 0.0) << "%), "
+        << overflows << " overflows, " << underflows << " underflows" << endl;
+}
@@ -0,0 +1,70 @@
+#ifndef TARGET_PREDICTOR_HPP
+#define TARGET_PREDICTOR_HPP
+
+#include <ostream>
+#include <vector>
+
+// Target prediction for JAL/JALR at fetch. PCs and targets are
+// instruction indices, as in IF.PC.
+
+// Direct-mapped branch target buffer tagged with the full PC
+class BranchTargetBuffer
+{
+public:
+    explicit BranchTargetBuffer(int entries);
+
+    // True (and the stored target) if pc hits
+    bool Lookup(int pc, int &target);
+
+    // Record the resolved target of the jump at pc; `predicted` is the
+    // target fetch used (-1 if the lookup missed)
+    void Update(int pc, int target, int predicted);
+
+    long Lookups() const { return lookups; }
+    long Hits() const { return hits; }
+    long WrongTargets() const { return wrongTargets; }
+    void Report(std::ostream &out) const;
+
+private:
+    std::vector<int> tags; // -1 = invalid
+    std::vector<int> targets;
+    int mask;
+    long lookups = 0;
+    long hits = 0;
+    long wrongTargets = 0;
+};
+
+// Return address stack: calls push their link value, returns pop it.
+// Overflow wraps around and overwrites the oldest entry.
+class ReturnAddressStack
+{
+public:
+    explicit ReturnAddressStack(int depth);
+
+    void Push(int link);
+    // False if the stack is empty
+    bool Pop(int &link);
+
+    // Count a resolved return whose fetch used the stack
+    void Resolve(bool correct)
+    {
+        returns++;
+        if (correct)
+            this->correct++;
+    }
+
+    long Returns() const { return returns; }
+    long Correct() const { return correct; }
+    void Report(std::ostream &out) const;
+
+private:
+    std::vector<int> entries;
+    int top;   // Index of the next free slot
+    int count; // Valid entries, at most entries.size()
+    long returns = 0;
+    long correct = 0;
+    long overflows = 0;
+    long underflows = 0;
+};
+
+#endif
@@ -0,0 +1,137 @@
+#include "TimingCore.hpp"
+#include <algorithm>
+#include <climits>
+#include <vector>
+using namespace std;
+
+TimingCore::TimingCore(const vector<DecodedInstr> &program, int width)
+    : Processor(program), width(width), fetchResume(0), missPC(-1), wrongPathPC(-1), onWrongPath(false)
+{
+}
+
+void TimingCore::resolve(const Op &op, const DecodedInstr &instr, long resumeAt)
+{
+    if (instr.Class == CLASS_BRANCH && predictor)
+        predictor->Resolve(op.InStr, op.out.taken, op.predictedTaken, op.history);
+    if (instr.Class == CLASS_JAL || instr.Class == CLASS_JALR)
+    {
+        if (op.fromRAS)
+            ras->Resolve(op.predictedTarget == op.out.next);
+        else if (btb)
+            btb->Update(op.InStr, op.out.next, op.predictedTarget);
+    }
+    if (!op.followed)
+        fetchResume = resumeAt;
+}
+
+void TimingCore::RecordFetch(PipelineDiagram &diagram, int cycle, int part) const
+{
+    for (size_t slot = 0; slot < fetched.size(); slot++)
+        diagram.Record(cycle, fetched[slot].InStr, 1, slot, part);
+    if (missPC >= 0)
+        diagram.Record(cycle, missPC, 1, fetched.size(), part);
+    if (onWrongPath && fetched.empty() && wrongPathPC >= 0 && wrongPathPC < (int)program.size())
+        diagram.Record(cycle, wrongPathPC, 1, 0, part);
+}
+
+// Calls write the link register (x1 or x5); returns jump through it to x0
+static bool isLink(int reg)
+{
+    return reg == 1 || reg == 5;
+}
+
+// Work out whether fetch, using the predictors, already follows the
+// branch or jump in op. Returns true if the fetch group ends here.
+bool TimingCore::predict(Op &op, const DecodedInstr &instr)
+{
+    op.followed = true;
+    op.predictedTaken = false;
+    op.history = 0;
+    op.predictedTarget = -1;
+    op.fromRAS = false;
+    if (instr.Class == CLASS_BRANCH)
+    {
+        if (predictor)
+        {
+            op.history = predictor->History();
+            op.predictedTaken = predictor->Predict(op.InStr, op.InStr + instr.Imm / 4);
+            op.followed = (op.predictedTaken == op.out.taken);
+        }
+        else
+            op.followed = false;
+    }
+    else if (instr.Class == CLASS_JAL || instr.Class == CLASS_JALR)
+    {
+        int target, link;
+        if (ras && instr.Class == CLASS_JALR && instr.WR == 0 && isLink(instr.RR1))
+        {
+            if (ras->Pop(link))
+            {
+                op.predictedTarget = (link + instr.Imm) / 4;
+                op.fromRAS = true;
+            }
+        }
+        else if (btb && btb->Lookup(op.InStr, target))
+            op.predictedTarget = target;
+        if (ras && isLink(instr.WR))
+            ras->Push(op.InStr + 1);
+        op.followed = (op.predictedTarget == op.out.next);
+    }
+    else
+        return false;
+
+    if (!op.followed)
+    {
+        fetchResume = LONG_MAX;
+        // What the 5-stage pipeline would fetch (and squash) meanwhile
+        wrongPathPC = (op.predictedTaken && instr.Class == CLASS_BRANCH) ? op.InStr + instr.Imm / 4
+                      : (op.predictedTarget != -1)                      ? op.predictedTarget
+                                                                        : op.InStr + 1;
+    }
+    return !op.followed || op.out.next != op.InStr + 1;
+}
+
+void TimingCore::process_IF()
+{
+    onWrongPath = (fetchResume == LONG_MAX);
+    if (now < fetchResume)
+        return;
+    while ((int)fetched.size() < width && IF.PC >= 0 && IF.PC < (int)program.size())
+    {
+        int pc = IF.PC;
+        // An I-cache miss ends the group; the same PC is fetched once the
+        // line has arrived
+        if (icache)
+        {
+            if (fetchFilled)
+            {
+                fetchFilled = false;
+                missPC = -1;
+            }
+            else
+            {
+                int extra = icache->Access(CODE_BASE + 4 * (uint32_t)pc, false, now) - 1;
+                if (extra > 0)
+                {
+                    fetchResume = now + extra;
+                    fetchFilled = true;
+                    missPC = pc;
+                    return;
+                }
+            }
+        }
+
+        const DecodedInstr &instr = program[pc];
+        Op op;
+        op.InStr = pc;
+        op.fetchedAt = now;
+        op.out = ExecuteInstr(instr, pc, RegFile[max(0, (int)instr.RR1)].value, RegFile[max(0, (int)instr.RR2)].value, MEM);
+        if (instr.RegWrite && instr.WR != 0)
+            RegFile[instr.WR].value = op.out.result;
+        IF.PC = op.out.next;
+        bool endGroup = predict(op, instr);
+        fetched.push_back(op);
+        if (endGroup)
+            break;
+    }
+}
@@ -0,0 +1,67 @@
+#ifndef TIMING_CORE_HPP
+#define TIMING_CORE_HPP
+
+#include <vector>
+#include "Processor.hpp"
+#include "Execute.hpp"
+#include "PipelineDiagram.hpp"
+
+// Front end shared by the superscalar and out-of-order cores. Instructions
+// execute architecturally when they are fetched (ExecuteInstr, as in the
+// functional model), so fetch always follows the correct path and the
+// stages behind it only model timing.
+//
+// IF fetches up to `width` instructions per cycle, ending the group at a
+// taken branch or jump. A branch or jump whose next PC the predictors did
+// not supply stops fetch until the core resolves it (resolve()); an I-cache
+// miss stops it until the line has arrived.
+class TimingCore : public Processor
+{
+public:
+    int Width() const { return width; }
+
+protected:
+    struct Op
+    {
+        int InStr;
+        ExecOutcome out;
+        bool followed;       // Fetch continued on the right path without waiting for resolve()
+        bool predictedTaken; // Direction predictor's guess for a conditional branch
+        uint32_t history;    // Predictor's global history when it made the guess
+        int predictedTarget; // Target fetch jumped to for a JAL/JALR, -1 if none
+        bool fromRAS;
+        long fetchedAt;      // Cycle it was fetched in
+    };
+
+    TimingCore(const std::vector<DecodedInstr> &program, int width);
+
+    void process_IF();
+
+    // Train the predictors with the outcome of the branch or jump op and,
+    // if fetch was waiting for it, let fetch continue from cycle resumeAt
+    void resolve(const Op &op, const DecodedInstr &instr, long resumeAt);
+
+    // Mark the instructions in IF (from slot 0) in diagram, including one
+    // waiting for its I-cache line and, once the branch or jump fetch waits
+    // for has left IF, the fetch the 5-stage pipeline would squash. part is
+    // 1 when IF is split into several stages.
+    void RecordFetch(PipelineDiagram &diagram, int cycle, int part = 0) const;
+
+    static bool IsControl(const DecodedInstr &instr)
+    {
+        return instr.Class == CLASS_BRANCH || instr.Class == CLASS_JAL || instr.Class == CLASS_JALR;
+    }
+
+    int width;
+    std::vector<Op> fetched; // IF, oldest first
+    long fetchResume;        // First cycle fetch may run (LONG_MAX: waiting for a branch or jump)
+
+private:
+    int missPC;       // Instruction whose I-cache line fetch waits for, -1 if none
+    int wrongPathPC;  // Shown in IF while fetch waits for a branch or jump
+    bool onWrongPath; // Fetch waited for a branch or jump this cycle
+
+    bool predict(Op &op, const DecodedInstr &instr);
+};
+
+#endif
@@ -0,0 +1,323 @@
+// Micro-benchmark for the instruction decoder, against the string-based
+// decoder it replaced.
+// Usage: ./bench_decode <input.txt> [iterations]
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+#include <bitset>
+#include "Predecode.hpp"
+
+using namespace std;
+
+static string legacyHexToBin(const string &hex)
+{
+    string binary;
+    for (char ch : hex)
+    {
+        int val = stoi(string(1, ch), nullptr, 16);
+        binary += bitset<4>(val).to_string();
+    }
+    return binary;
+}
+
+// Sign-extend an immediate given as a binary string
+static int32_t legacySignExtend(const string &imm_str)
+{
+    int32_t imm_val = stoi(imm_str, nullptr, 2);
+    if (imm_str[0] == '1')
+    {
+        imm_val -= (1 << imm_str.size());
+    }
+    return imm_val;
+}
+
+// The string-compare decoder Predecode() replaced, kept as the baseline:
+// the instruction is expanded to a string of 32 '0'/'1' characters and
+// its fields are compared as substrings (RV32I only)
+static DecodedInstr legacyPredecode(const string &hex)
+{
+    DecodedInstr d = {};
+    d.Class = CLASS_UNKNOWN;
+
+    string instr = legacyHexToBin(hex);
+    if (instr.size() != 32)
+        return d;
+
+    string opcode = instr.substr(25, 7);
+    string funct7 = instr.substr(0, 7);
+    string funct3 = instr.substr(17, 3);
+    int rs1 = stoi(instr.substr(12, 5), nullptr, 2);
+    int rs2 = stoi(instr.substr(7, 5), nullptr, 2);
+    int rd = stoi(instr.substr(20, 5), nullptr, 2);
+
+    // R-type: opcode = 0110011
+    if (opcode == "0110011")
+    {
+        int op = 0;
+        if (funct7 == "0000000")
+        {
+            if (funct3 == "000")
+                op = 2; // ADD
+            else if (funct3 == "001")
+                op = 7; // SLL
+            else if (funct3 == "101")
+                op = 8; // SRL
+            else if (funct3 == "010")
+                op = 10; // SLT
+            else if (funct3 == "011")
+                op = 11; // SLTU
+            else if (funct3 == "111")
+                op = 4; // AND
+            else if (funct3 == "110")
+                op = 5; // OR
+            else if (funct3 == "100")
+                op = 6; // XOR
+        }
+        else if (funct7 == "0100000")
+        {
+            if (funct3 == "000")
+                op = 3; // SUB
+            else if (funct3 == "101")
+                op = 9; // SRA
+        }
+        if (op == 0)
+            return d;
+
+        d.Class = CLASS_ALU;
+        d.RR1 = rs1;
+        d.RR2 = rs2;
+        d.WR = rd;
+        d.RegWrite = true;
+        d.RegDst = true;
+        d.ALUOp = op;
+    }
+    // I-type instructions (non-load)
+    else if (opcode == "0010011")
+    {
+        int op = 0;
+        int32_t imm = legacySignExtend(instr.substr(0, 12));
+        if (funct3 == "000")
+            op = 2; // ADDI
+        else if (funct3 == "001" && funct7 == "0000000")
+            op = 7; // SLLI
+        else if (funct3 == "101" && funct7 == "0000000")
+            op = 8; // SRLI
+        else if (funct3 == "101" && funct7 == "0100000")
+            op = 9; // SRAI
+        else if (funct3 == "010")
+            op = 10; // SLTI
+        else if (funct3 == "011")
+            op = 11; // SLTIU
+        else if (funct3 == "111")
+            op = 4; // ANDI
+        else if (funct3 == "110")
+            op = 5; // ORI
+        else if (funct3 == "100")
+            op = 6; // XORI
+        if (op == 0)
+            return d;
+
+        // For shift immediates, the shift amount comes from bits 7-11 (shamt)
+        if (op >= 7 && op <= 9)
+            imm = rs2;
+
+        d.Class = CLASS_ALU;
+        d.RR1 = rs1;
+        d.RR2 = -1;
+        d.WR = rd;
+        d.Imm = imm;
+        d.RegWrite = true;
+        d.ALUSrc = true;
+        d.ALUOp = op;
+    }
+    // LUI: Load Upper Immediate (U-type instruction)
+    else if (opcode == "0110111")
+    {
+        d.Class = CLASS_ALU;
+        d.RR1 = -1;
+        d.RR2 = -1;
+        d.WR = rd;
+        d.Imm = stoi(instr.substr(0, 20), nullptr, 2) << 12;
+        d.RegWrite = true;
+        d.ALUSrc = true; // Uses immediate value
+        d.ALUOp = 20;    // LUI operation (pass immediate)
+    }
+    // I-type load instructions
+    else if (opcode == "0000011")
+    {
+        d.Class = CLASS_LOAD;
+        d.RR1 = rs1; // base register
+        d.RR2 = -1;
+        d.WR = rd; // destination register
+        d.Imm = legacySignExtend(instr.substr(0, 12));
+        d.RegWrite = true;
+        d.MemRead = true;
+        d.ALUSrc = true;
+        d.ALUOp = 2; // Address calculation uses addition
+        d.MemtoReg = true;
+
+        if (funct3 == "010")
+        { // LW
+            d.MemSize = 4;
+            d.MemSignExtend = true;
+        }
+        else if (funct3 == "001")
+        { // LH
+            d.MemSize = 2;
+            d.MemSignExtend = true;
+        }
+        else if (funct3 == "101")
+        { // LHU
+            d.MemSize = 2;
+        }
+        else if (funct3 == "000")
+        { // LB
+            d.MemSize = 1;
+            d.MemSignExtend = true;
+        }
+        else if (funct3 == "100")
+        { // LBU
+            d.MemSize = 1;
+        }
+    }
+    // S-type: Store instructions
+    else if (opcode == "0100011")
+    {
+        d.Class = CLASS_STORE;
+        d.RR1 = rs1; // base register
+        d.RR2 = rs2; // source register
+        // S-type immediate: imm[11:5] is in bits 0-6, imm[4:0] is in bits 20-24
+        d.Imm = legacySignExtend(funct7 + instr.substr(20, 5));
+        d.MemWrite = true;
+        d.ALUSrc = true;
+        d.ALUOp = 2; // Address calculation uses addition
+
+        if (funct3 == "010")
+            d.MemSize = 4; // SW
+        else if (funct3 == "001")
+            d.MemSize = 2; // SH
+        else if (funct3 == "000")
+            d.MemSize = 1; // SB
+    }
+    // B-type: Branch instructions
+    else if (opcode == "1100011")
+    {
+        int type = -1;
+        if (funct3 == "000")
+            type = 0; // BEQ
+        else if (funct3 == "001")
+            type = 1; // BNE
+        else if (funct3 == "100")
+            type = 2; // BLT
+        else if (funct3 == "101")
+            type = 3; // BGE
+        else if (funct3 == "110")
+            type = 4; // BLTU
+        else if (funct3 == "111")
+            type = 5; // BGEU
+        if (type == -1)
+            return d;
+
+        d.Class = CLASS_BRANCH;
+        d.RR1 = rs1;
+        d.RR2 = rs2;
+        // B-type immediate format: imm[12|10:5|4:1|11], bit 0 is always 0
+        d.Imm = legacySignExtend(instr.substr(0, 1) + instr.substr(24, 1) + instr.substr(1, 6) + instr.substr(20, 4) + "0");
+        d.BranchType = type;
+        // BEQ/BNE compare with SUB, BLT/BGE with SLT, BLTU/BGEU with SLTU
+        d.ALUOp = (type < 2) ? 3 : (type < 4) ? 10 : 11;
+    }
+    // J-type: JAL (Jump and Link)
+    else if (opcode == "1101111")
+    {
+        d.Class = CLASS_JAL;
+        d.RR1 = -1;
+        d.RR2 = -1;
+        d.WR = rd;
+        // Extract the 20-bit immediate: imm[20|19:12|11|10:1], then shift to a byte offset
+        d.Imm = legacySignExtend(instr.substr(0, 1) + instr.substr(12, 8) + instr.substr(11, 1) + instr.substr(1, 10)) << 1;
+        d.RegWrite = true;
+        d.ALUSrc = true;
+        d.ALUOp = 2;
+    }
+    // I-type: JALR (Jump and Link Register)
+    else if (opcode == "1100111" && funct3 == "000")
+    {
+        d.Class = CLASS_JALR;
+        d.RR1 = rs1;
+        d.RR2 = -1;
+        d.WR = rd;
+        d.Imm = legacySignExtend(instr.substr(0, 12));
+        d.RegWrite = true;
+        d.ALUSrc = true; // ALU uses immediate
+        d.ALUOp = 2;     // Addition for rs1 + imm
+    }
+    return d;
+}
+
+// Sink so the compiler cannot drop the decode calls
+static volatile int sink;
+
+template <typename F>
+static double decodesPerSec(size_t count, long iterations, F decode)
+{
+    auto start = chrono::steady_clock::now();
+    for (long it = 0; it < iterations; it++)
+        for (size_t i = 0; i < count; i++)
+            sink = decode(i).ALUOp;
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+    return count * (double)iterations / elapsed.count();
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        cerr << "Usage: " << argv[0] << " <input.txt> [iterations]" << endl;
+        return 1;
+    }
+    long iterations = (argc > 2) ? atol(argv[2]) : 200000;
+
+    ifstream file(argv[1]);
+    if (!file)
+    {
+        cerr << "Error: Unable to open input file " << argv[1] << endl;
+        return 1;
+    }
+    vector<string> hex;
+    vector<uint32_t> words;
+    string line;
+    while (getline(file, line))
+    {
+        stringstream ss(line);
+        string word;
+        uint32_t value;
+        if (ss >> word && hexToWord(word, value))
+        {
+            hex.push_back(word);
+            words.push_back(value);
+        }
+    }
+    if (words.empty())
+    {
+        cerr << "Error: no instructions in " << argv[1] << endl;
+        return 1;
+    }
+
+    double legacy = decodesPerSec(hex.size(), iterations / 200 + 1, [&](size_t i)
+                                  { return legacyPredecode(hex[i]); });
+    double fromHex = decodesPerSec(hex.size(), iterations / 10 + 1, [&](size_t i)
+                                   { return Predecode(hex[i]); });
+    double fromWord = decodesPerSec(words.size(), iterations, [&](size_t i)
+                                    { return DecodeWord(words[i]); });
+
+    cout << "instructions: " << words.size() << endl;
+    cout << "string decoder:   " << legacy / 1e6 << " M decodes/sec (baseline)" << endl;
+    cout << "Predecode(hex):   " << fromHex / 1e6 << " M decodes/sec" << endl;
+    cout << "DecodeWord(word): " << fromWord / 1e6 << " M decodes/sec" << endl;
+    return 0;
+}
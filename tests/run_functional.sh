@@ -0,0 +1,19 @@
+#!/bin/bash
+# Architectural checks: run every tests/<name>.txt with --functional on
+# both simulators and compare the register dump with <name>.expected.
+# Usage: tests/run_functional.sh [bindir] (default: src next to this script)
+DIR=$(cd "$(dirname "$0")" && pwd)
+BIN=${1:-$DIR/../src}
+rc=0
+for prog in "$DIR"/*.txt; do
+    name=$(basename "$prog" .txt)
+    for sim in forward noforward; do
+        if "$BIN/$sim" "$prog" 1000 --functional 2>/dev/null | diff -u "$DIR/$name.expected" - >/dev/null; then
+            echo "PASS $name ($sim)"
+        else
+            echo "FAIL $name ($sim)"
+            rc=1
+        fi
+    done
+done
+exit $rc